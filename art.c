@@ -1,75 +1,475 @@
-#include "art.h"
-#include <gio/gio.h>
-#include <gdk-pixbuf/gdk-pixbuf.h>
-#include <string.h>
-
-void clear_album_art_container(GtkWidget *container) {
-    GtkWidget *child = gtk_widget_get_first_child(container);
-    while (child) {
-        GtkWidget *next = gtk_widget_get_next_sibling(child);
-        gtk_widget_unparent(child);
-        child = next;
-    }
-}
-
-GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size) {
-    if (!art_url || strlen(art_url) == 0 || !container) return NULL;
-
-    GdkPixbuf *pixbuf = NULL;
-
-    if (g_str_has_prefix(art_url, "file://")) {
-        gchar *file_path = g_filename_from_uri(art_url, NULL, NULL);
-        if (file_path && g_file_test(file_path, G_FILE_TEST_EXISTS)) {
-            GError *error = NULL;
-            pixbuf = gdk_pixbuf_new_from_file_at_scale(file_path, size, size, FALSE, &error);
-            if (error) {
-                g_error_free(error);
-                pixbuf = NULL;
-            }
-        }
-        g_free(file_path);
-    } else if (g_str_has_prefix(art_url, "http://") || g_str_has_prefix(art_url, "https://")) {
-        GFile *file = g_file_new_for_uri(art_url);
-        GError *error = NULL;
-        GInputStream *stream = G_INPUT_STREAM(g_file_read(file, NULL, &error));
-        if (stream && !error) {
-            pixbuf = gdk_pixbuf_new_from_stream_at_scale(stream, size, size, FALSE, NULL, &error);
-            if (error) {
-                g_error_free(error);
-                pixbuf = NULL;
-            }
-            g_object_unref(stream);
-        } else if (error) {
-            g_error_free(error);
-        }
-        g_object_unref(file);
-    }
-
-    if (!pixbuf) return NULL;
-
-    GdkTexture *texture = gdk_texture_new_for_pixbuf(pixbuf);
-    GtkWidget *image = gtk_picture_new_for_paintable(GDK_PAINTABLE(texture));
-    gtk_widget_set_size_request(image, size, size);
-
-    // For larger sizes (main widget), add extra layout controls
-    if (size > 100) {
-        gtk_picture_set_can_shrink(GTK_PICTURE(image), TRUE);
-        gtk_picture_set_content_fit(GTK_PICTURE(image), GTK_CONTENT_FIT_CONTAIN);
-        gtk_widget_set_halign(image, GTK_ALIGN_CENTER);
-        gtk_widget_set_valign(image, GTK_ALIGN_CENTER);
-        gtk_widget_set_hexpand(image, FALSE);
-        gtk_widget_set_vexpand(image, FALSE);
-    } else {
-        // For notifications, use simpler fill approach
-        gtk_picture_set_content_fit(GTK_PICTURE(image), GTK_CONTENT_FIT_COVER);
-    }
-
-    // Clear existing art and add new
-    clear_album_art_container(container);
-    gtk_box_append(GTK_BOX(container), image);
-
-    g_object_unref(texture);
-    g_object_unref(pixbuf);
-
-    return image;
-}
+#include "art.h"
+#include "art_cache.h"
+#include "art_fetch.h"
+#include <gio/gio.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+// Art is decoded once at the largest size shown (main view) and smaller
+// pictures (notifications) draw the same texture scaled down
+#define ART_DECODE_SIZE 300
+#define ART_TEXTURE_CACHE_SIZE 16  // Resident textures (~360 KB each at 300px)
+
+// Low-res first stage, drawn scaled up (and so softened) until the full decode lands
+#define ART_PREVIEW_SIZE 48
+#define ART_THUMBNAIL_CACHE_SIZE 256  // Resident thumbnails (~9 KB each)
+#define ART_PREVIEW_MIN_BYTES (256 * 1024)  // Smaller sources decode fully about as fast
+
+// Container's pending request (ArtWaiter*), set while its fetch runs
+#define ART_LOAD_KEY "hyprwave-art-load"
+
+// One fetch + decode per URL, shared by every container that wants it
+typedef struct {
+    gchar *art_url;
+    gint size;                  // Decode size
+    GCancellable *cancellable;  // Cancelled once no container waits for it
+    GList *waiters;             // ArtWaiter*
+} ArtFetch;
+
+// Worker's own copy: a cancelled task returns early and the fetch is freed
+// while the worker may still be running
+typedef struct {
+    gchar *art_url;
+    gint size;
+} ArtRequest;
+
+typedef struct {
+    ArtFetch *fetch;
+    GtkWidget *container;
+    gint size;                  // Size the container shows art at
+} ArtWaiter;
+
+typedef struct {
+    gchar *art_url;
+    GdkTexture *texture;
+} CachedTexture;
+
+// URL-keyed LRU of textures
+typedef struct {
+    GQueue lru;                 // CachedTexture*, most recently used first
+    GHashTable *index;          // URL -> GList* link in lru
+    guint capacity;
+} TextureCache;
+
+// Worker result: the full texture and a thumbnail of it for the placeholder stage
+typedef struct {
+    GdkTexture *texture;
+    GdkTexture *thumbnail;
+} ArtResult;
+
+// Worker -> main loop: low-res stage for whoever still waits on art_url
+typedef struct {
+    gchar *art_url;
+    GdkTexture *texture;
+} ArtPreview;
+
+static GHashTable *fetches_in_flight = NULL;  // URL -> ArtFetch*
+static TextureCache textures = { G_QUEUE_INIT, NULL, ART_TEXTURE_CACHE_SIZE };
+static TextureCache thumbnails = { G_QUEUE_INIT, NULL, ART_THUMBNAIL_CACHE_SIZE };
+
+// ========================================
+// TEXTURE CACHE (main thread)
+// ========================================
+
+static gboolean is_remote_url(const gchar *art_url) {
+    return g_str_has_prefix(art_url, "http://") || g_str_has_prefix(art_url, "https://");
+}
+
+static void cached_texture_free(CachedTexture *cached) {
+    g_object_unref(cached->texture);
+    g_free(cached->art_url);
+    g_free(cached);
+}
+
+static GdkTexture* texture_cache_lookup(TextureCache *cache, const gchar *art_url, gint size) {
+    if (!cache->index) return NULL;
+
+    GList *link = g_hash_table_lookup(cache->index, art_url);
+    if (!link) return NULL;
+
+    CachedTexture *cached = link->data;
+    if (gdk_texture_get_width(cached->texture) < size) return NULL;  // Too small to scale down from
+
+    g_queue_unlink(&cache->lru, link);
+    g_queue_push_head_link(&cache->lru, link);
+    return cached->texture;
+}
+
+static void texture_cache_insert(TextureCache *cache, const gchar *art_url, GdkTexture *texture) {
+    // Local files (often reused temp paths) may change under the same URL; only remote art is kept
+    if (!is_remote_url(art_url)) return;
+
+    if (!cache->index) {
+        cache->index = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+
+    GList *link = g_hash_table_lookup(cache->index, art_url);
+    if (link) {
+        CachedTexture *cached = link->data;
+        g_object_unref(cached->texture);
+        cached->texture = g_object_ref(texture);
+        g_queue_unlink(&cache->lru, link);
+        g_queue_push_head_link(&cache->lru, link);
+        return;
+    }
+
+    CachedTexture *cached = g_new0(CachedTexture, 1);
+    cached->art_url = g_strdup(art_url);
+    cached->texture = g_object_ref(texture);
+    g_queue_push_head(&cache->lru, cached);
+    g_hash_table_insert(cache->index, cached->art_url, cache->lru.head);
+
+    while (cache->lru.length > cache->capacity) {
+        CachedTexture *oldest = g_queue_pop_tail(&cache->lru);
+        g_hash_table_remove(cache->index, oldest->art_url);
+        cached_texture_free(oldest);
+    }
+}
+
+// ========================================
+// LOADING
+// ========================================
+
+static void remove_art_children(GtkWidget *container) {
+    GtkWidget *child = gtk_widget_get_first_child(container);
+    while (child) {
+        GtkWidget *next = gtk_widget_get_next_sibling(child);
+        gtk_widget_unparent(child);
+        child = next;
+    }
+}
+
+static void art_waiter_free(ArtWaiter *waiter) {
+    g_object_unref(waiter->container);
+    g_free(waiter);
+}
+
+static void art_request_free(gpointer data) {
+    ArtRequest *request = (ArtRequest *)data;
+    g_free(request->art_url);
+    g_free(request);
+}
+
+static void art_fetch_free(ArtFetch *fetch) {
+    g_object_unref(fetch->cancellable);
+    g_free(fetch->art_url);
+    g_free(fetch);
+}
+
+// Stop waiting for the container's fetch; the fetch itself is cancelled
+// once nobody else waits for it
+static void cancel_art_load(GtkWidget *container) {
+    ArtWaiter *waiter = g_object_steal_data(G_OBJECT(container), ART_LOAD_KEY);
+    if (!waiter) return;
+
+    ArtFetch *fetch = waiter->fetch;
+    fetch->waiters = g_list_remove(fetch->waiters, waiter);
+    if (!fetch->waiters) {
+        g_cancellable_cancel(fetch->cancellable);
+        // New requests for this URL must not join a cancelled fetch
+        if (g_hash_table_lookup(fetches_in_flight, fetch->art_url) == fetch) {
+            g_hash_table_remove(fetches_in_flight, fetch->art_url);
+        }
+    }
+    art_waiter_free(waiter);
+}
+
+void clear_album_art_container(GtkWidget *container) {
+    cancel_art_load(container);
+    remove_art_children(container);
+}
+
+gboolean album_art_is_loading(GtkWidget *container) {
+    return g_object_get_data(G_OBJECT(container), ART_LOAD_KEY) != NULL;
+}
+
+static void install_art(GtkWidget *container, GdkTexture *texture, gint size) {
+    GtkWidget *image = gtk_picture_new_for_paintable(GDK_PAINTABLE(texture));
+    gtk_widget_set_size_request(image, size, size);
+
+    // For larger sizes (main widget), add extra layout controls
+    if (size > 100) {
+        gtk_picture_set_can_shrink(GTK_PICTURE(image), TRUE);
+        gtk_picture_set_content_fit(GTK_PICTURE(image), GTK_CONTENT_FIT_CONTAIN);
+        gtk_widget_set_halign(image, GTK_ALIGN_CENTER);
+        gtk_widget_set_valign(image, GTK_ALIGN_CENTER);
+        gtk_widget_set_hexpand(image, FALSE);
+        gtk_widget_set_vexpand(image, FALSE);
+    } else {
+        // For notifications, use simpler fill approach
+        gtk_picture_set_content_fit(GTK_PICTURE(image), GTK_CONTENT_FIT_COVER);
+    }
+
+    // Clear existing art and add new
+    remove_art_children(container);
+    gtk_box_append(GTK_BOX(container), image);
+}
+
+// ========================================
+// PREVIEW STAGE
+// ========================================
+
+static void art_preview_free(gpointer data) {
+    ArtPreview *preview = (ArtPreview *)data;
+    g_object_unref(preview->texture);
+    g_free(preview->art_url);
+    g_free(preview);
+}
+
+static gboolean deliver_art_preview(gpointer user_data) {
+    ArtPreview *preview = (ArtPreview *)user_data;
+
+    // Runs before the fetch's completion (same priority, queued earlier);
+    // a finished or cancelled fetch is no longer in the table
+    ArtFetch *fetch = fetches_in_flight ? g_hash_table_lookup(fetches_in_flight, preview->art_url) : NULL;
+    if (fetch) {
+        for (GList *l = fetch->waiters; l; l = l->next) {
+            ArtWaiter *waiter = l->data;
+            install_art(waiter->container, preview->texture, waiter->size);
+        }
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Worker thread: hand a low-res decode to the main loop while the full one runs
+static void post_art_preview(const gchar *art_url, GdkPixbuf *pixbuf, GCancellable *cancellable) {
+    if (g_cancellable_is_cancelled(cancellable)) return;
+
+    ArtPreview *preview = g_new0(ArtPreview, 1);
+    preview->art_url = g_strdup(art_url);
+    preview->texture = gdk_texture_new_for_pixbuf(pixbuf);
+    g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, deliver_art_preview,
+                               preview, art_preview_free);
+}
+
+// Main loop, same frame as the request and without touching the disk: a
+// resident thumbnail if there is one, otherwise an empty container (its
+// themed background) instead of the previous track's cover. The worker
+// posts a thumbnail from the disk cache as soon as it reads one.
+static void show_art_placeholder(const gchar *art_url, GtkWidget *container, gint size) {
+    GdkTexture *thumbnail = texture_cache_lookup(&thumbnails, art_url, 0);
+    if (thumbnail) {
+        install_art(container, thumbnail, size);
+    } else {
+        remove_art_children(container);
+    }
+}
+
+// ========================================
+// DECODING (worker thread)
+// ========================================
+
+// Worker thread: download (or read) and decode at the target size
+static GdkPixbuf* load_art_pixbuf(const gchar *art_url, gint size, GCancellable *cancellable) {
+    GdkPixbuf *pixbuf = NULL;
+    GError *error = NULL;
+
+    if (g_str_has_prefix(art_url, "file://")) {
+        gchar *file_path = g_filename_from_uri(art_url, NULL, NULL);
+        GStatBuf st;
+        if (file_path && g_stat(file_path, &st) == 0) {
+            // Large covers (full-resolution embedded art): a cheap downscaled decode first
+            if (st.st_size >= ART_PREVIEW_MIN_BYTES) {
+                GdkPixbuf *preview = gdk_pixbuf_new_from_file_at_scale(file_path, ART_PREVIEW_SIZE,
+                                                                       ART_PREVIEW_SIZE, TRUE, NULL);
+                if (preview) {
+                    post_art_preview(art_url, preview, cancellable);
+                    g_object_unref(preview);
+                }
+            }
+            pixbuf = gdk_pixbuf_new_from_file_at_scale(file_path, size, size, FALSE, &error);
+        }
+        g_free(file_path);
+    } else if (is_remote_url(art_url)) {
+        // Repeat plays: pre-scaled copy from disk, no network and no full-size decode
+        GdkPixbuf *cached = art_cache_lookup(art_url, size);
+        if (cached && art_cache_is_fresh(cached)) return cached;
+
+        // A network round-trip follows: show the stale copy while revalidating,
+        // or the disk thumbnail if that is all there is
+        if (cached) {
+            post_art_preview(art_url, cached, cancellable);
+        } else {
+            GdkPixbuf *thumbnail = art_cache_lookup(art_url, ART_PREVIEW_SIZE);
+            if (thumbnail) {
+                post_art_preview(art_url, thumbnail, cancellable);
+                g_object_unref(thumbnail);
+            }
+        }
+
+        // Missing or due for revalidation: conditional GET with the stored validators
+        ArtFetchResponse response = { 0 };
+        ArtFetchStatus status = art_fetch_http(art_url,
+                                               cached ? art_cache_get_etag(cached) : NULL,
+                                               cached ? art_cache_get_last_modified(cached) : NULL,
+                                               cancellable, &response, &error);
+
+        if (status == ART_FETCH_OK) {
+            if (!cached && g_bytes_get_size(response.body) >= ART_PREVIEW_MIN_BYTES) {
+                GInputStream *stream = g_memory_input_stream_new_from_bytes(response.body);
+                GdkPixbuf *preview = gdk_pixbuf_new_from_stream_at_scale(stream, ART_PREVIEW_SIZE,
+                                                                         ART_PREVIEW_SIZE, TRUE,
+                                                                         cancellable, NULL);
+                g_object_unref(stream);
+                if (preview) {
+                    post_art_preview(art_url, preview, cancellable);
+                    g_object_unref(preview);
+                }
+            }
+
+            GInputStream *stream = g_memory_input_stream_new_from_bytes(response.body);
+            pixbuf = gdk_pixbuf_new_from_stream_at_scale(stream, size, size, FALSE, cancellable, &error);
+            g_object_unref(stream);
+
+            if (pixbuf) {
+                art_cache_store(art_url, size, pixbuf, response.etag, response.last_modified);
+
+                // Thumbnail for the next cold start's placeholder stage
+                GdkPixbuf *thumbnail = gdk_pixbuf_scale_simple(pixbuf, ART_PREVIEW_SIZE, ART_PREVIEW_SIZE,
+                                                               GDK_INTERP_BILINEAR);
+                art_cache_store(art_url, ART_PREVIEW_SIZE, thumbnail, response.etag, response.last_modified);
+                g_object_unref(thumbnail);
+            }
+        } else if (status == ART_FETCH_NOT_MODIFIED) {
+            // Still current: re-stamp it so the next plays skip the round-trip
+            art_cache_store(art_url, size, cached, art_cache_get_etag(cached),
+                            art_cache_get_last_modified(cached));
+        } else if (cached && error && !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            g_printerr("Album art revalidation failed, using cached copy: %s\n", error->message);
+        }
+        art_fetch_response_clear(&response);
+
+        // Stale art beats no art when the server is unreachable
+        if (!pixbuf && cached) {
+            pixbuf = cached;
+        } else if (cached) {
+            g_object_unref(cached);
+        }
+    }
+
+    if (error) g_error_free(error);
+    return pixbuf;
+}
+
+static void art_result_free(gpointer data) {
+    ArtResult *art = (ArtResult *)data;
+    g_object_unref(art->texture);
+    g_object_unref(art->thumbnail);
+    g_free(art);
+}
+
+static void load_art_thread(GTask *task, gpointer source_object,
+                            gpointer task_data, GCancellable *cancellable) {
+    ArtRequest *request = (ArtRequest *)task_data;
+    (void)source_object;
+
+    GdkPixbuf *pixbuf = load_art_pixbuf(request->art_url, request->size, cancellable);
+    if (!pixbuf) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                                "Could not load album art from %s", request->art_url);
+        return;
+    }
+
+    // Textures are immutable, so the upload copies can be made here too
+    GdkPixbuf *thumbnail = gdk_pixbuf_scale_simple(pixbuf, ART_PREVIEW_SIZE, ART_PREVIEW_SIZE,
+                                                   GDK_INTERP_BILINEAR);
+    ArtResult *art = g_new0(ArtResult, 1);
+    art->texture = gdk_texture_new_for_pixbuf(pixbuf);
+    art->thumbnail = gdk_texture_new_for_pixbuf(thumbnail);
+    g_object_unref(thumbnail);
+    g_object_unref(pixbuf);
+    g_task_return_pointer(task, art, art_result_free);
+}
+
+// Main loop: cache the texture and hand it to every container still waiting
+static void on_art_loaded(GObject *source, GAsyncResult *result, gpointer user_data) {
+    ArtFetch *fetch = (ArtFetch *)user_data;
+    GError *error = NULL;
+    ArtResult *art = g_task_propagate_pointer(G_TASK(result), &error);
+    GdkTexture *texture = art ? art->texture : NULL;
+    (void)source;
+
+    if (g_hash_table_lookup(fetches_in_flight, fetch->art_url) == fetch) {
+        g_hash_table_remove(fetches_in_flight, fetch->art_url);
+    }
+
+    if (art) {
+        texture_cache_insert(&textures, fetch->art_url, art->texture);
+        texture_cache_insert(&thumbnails, fetch->art_url, art->thumbnail);
+    }
+
+    // A cancelled fetch has no waiters left; a failed one empties its containers
+    // rather than leaving the previous track's art in place
+    for (GList *l = fetch->waiters; l; l = l->next) {
+        ArtWaiter *waiter = l->data;
+        g_object_steal_data(G_OBJECT(waiter->container), ART_LOAD_KEY);
+        if (texture) {
+            install_art(waiter->container, texture, waiter->size);
+        } else {
+            remove_art_children(waiter->container);
+        }
+        art_waiter_free(waiter);
+    }
+    g_list_free(fetch->waiters);
+    fetch->waiters = NULL;
+
+    if (art) art_result_free(art);
+    if (error) g_error_free(error);
+    art_fetch_free(fetch);
+}
+
+void load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size) {
+    if (!container) return;
+
+    // Whatever was loading for this container is stale now
+    cancel_art_load(container);
+
+    if (!art_url || strlen(art_url) == 0) {
+        remove_art_children(container);
+        return;
+    }
+
+    // Resident texture (e.g. switching back to a player): no fetch, no decode
+    GdkTexture *texture = texture_cache_lookup(&textures, art_url, size);
+    if (texture) {
+        install_art(container, texture, size);
+        return;
+    }
+
+    // First stage now; the full-resolution texture replaces it when decoded
+    show_art_placeholder(art_url, container, size);
+
+    if (!fetches_in_flight) {
+        fetches_in_flight = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+
+    // Join a fetch of the same URL (main view and notification on a track change)
+    ArtFetch *fetch = g_hash_table_lookup(fetches_in_flight, art_url);
+    if (!fetch || fetch->size < size) {
+        fetch = g_new0(ArtFetch, 1);
+        fetch->art_url = g_strdup(art_url);
+        fetch->size = MAX(size, ART_DECODE_SIZE);
+        fetch->cancellable = g_cancellable_new();
+        // Replace, not insert: the key must be this fetch's own string, since
+        // a superseded fetch frees its art_url when it completes
+        g_hash_table_replace(fetches_in_flight, fetch->art_url, fetch);
+
+        ArtRequest *request = g_new0(ArtRequest, 1);
+        request->art_url = g_strdup(art_url);
+        request->size = fetch->size;
+
+        GTask *task = g_task_new(NULL, fetch->cancellable, on_art_loaded, fetch);
+        g_task_set_task_data(task, request, art_request_free);
+        g_task_set_return_on_cancel(task, TRUE);
+        g_task_run_in_thread(task, load_art_thread);
+        g_object_unref(task);
+    }
+
+    ArtWaiter *waiter = g_new0(ArtWaiter, 1);
+    waiter->fetch = fetch;
+    waiter->container = g_object_ref(container);
+    waiter->size = size;
+    fetch->waiters = g_list_append(fetch->waiters, waiter);
+    g_object_set_data(G_OBJECT(container), ART_LOAD_KEY, waiter);
+}
@@ -1,14 +1,25 @@
-#ifndef ART_H
-#define ART_H
-
-#include <gtk/gtk.h>
-
-// Load album art from URL (file:// or http(s)://) and append to container
-// Returns the created GtkPicture widget, or NULL on failure
-// The caller owns the container but the widget is automatically added
-GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size);
-
-// Clear all children from an album art container
-void clear_album_art_container(GtkWidget *container);
-
-#endif // ART_H
+#ifndef ART_H
+#define ART_H
+
+#include <gtk/gtk.h>
+
+// Load album art from URL (file:// or http(s)://) into container without blocking
+// Fetching and decoding run on a worker thread; the picture replaces the container's
+// children on the main loop once ready. A newer load or a clear for the same container
+// cancels the one in flight, so stale art is never installed.
+// An empty URL or a failed load leaves the container empty
+// Containers asking for the same URL share one fetch and decode, and recent remote
+// art stays resident as textures, so switching back to a player shows it immediately
+// Otherwise the container changes in the same frame, with no disk access on the main
+// thread: to a resident thumbnail of the new art if there is one, else to empty. The
+// worker then shows the disk-cached copy or thumbnail while it goes to the network, and
+// large sources get a quick low-res decode, before the full-resolution texture lands
+void load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size);
+
+// Cancel any in-flight load and clear all children from an album art container
+void clear_album_art_container(GtkWidget *container);
+
+// TRUE while a load for this container is still in flight
+gboolean album_art_is_loading(GtkWidget *container);
+
+#endif // ART_H
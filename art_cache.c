@@ -0,0 +1,183 @@
+#include "art_cache.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define STALE_TEMP_SECONDS 60  // Leftover temp files from an interrupted store
+
+// PNG text chunks; gdk-pixbuf exposes them as "tEXt::<key>" options on load
+#define KEY_ETAG "tEXt::hyprwave-etag"
+#define KEY_LAST_MODIFIED "tEXt::hyprwave-last-modified"
+#define KEY_CHECKED "tEXt::hyprwave-checked"
+
+typedef struct {
+    gchar *path;
+    gint64 size;
+    gint64 mtime;
+} CacheEntry;
+
+static gint cache_budget_mb = 0;  // Atomic
+static GMutex evict_lock;         // One eviction scan at a time
+
+void art_cache_set_budget_mb(gint megabytes) {
+    g_atomic_int_set(&cache_budget_mb, megabytes > 0 ? megabytes : 0);
+    if (megabytes > 0) {
+        g_print("✓ Album art cache: %d MB in %s/hyprwave/art\n", megabytes, g_get_user_cache_dir());
+    }
+}
+
+static gchar* cache_dir(void) {
+    return g_build_filename(g_get_user_cache_dir(), "hyprwave", "art", NULL);
+}
+
+// Content address: one file per (URL, size)
+static gchar* cache_path(const gchar *art_url, gint size) {
+    gchar *key = g_strdup_printf("%s\n%d", art_url, size);
+    gchar *hash = g_compute_checksum_for_string(G_CHECKSUM_SHA256, key, -1);
+    gchar *file_name = g_strconcat(hash, ".png", NULL);
+    gchar *dir = cache_dir();
+    gchar *path = g_build_filename(dir, file_name, NULL);
+
+    g_free(dir);
+    g_free(file_name);
+    g_free(hash);
+    g_free(key);
+    return path;
+}
+
+GdkPixbuf* art_cache_lookup(const gchar *art_url, gint size) {
+    if (g_atomic_int_get(&cache_budget_mb) == 0) return NULL;
+
+    gchar *path = cache_path(art_url, size);
+    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file(path, NULL);
+    if (pixbuf) {
+        g_utime(path, NULL);  // Most recently used
+    }
+    g_free(path);
+    return pixbuf;
+}
+
+gboolean art_cache_is_fresh(GdkPixbuf *cached) {
+    const gchar *checked = gdk_pixbuf_get_option(cached, KEY_CHECKED);
+    if (!checked) return FALSE;
+
+    gint64 age = g_get_real_time() / G_USEC_PER_SEC - g_ascii_strtoll(checked, NULL, 10);
+    return age >= 0 && age < ART_CACHE_FRESH_SECONDS;
+}
+
+const gchar* art_cache_get_etag(GdkPixbuf *cached) {
+    return gdk_pixbuf_get_option(cached, KEY_ETAG);
+}
+
+const gchar* art_cache_get_last_modified(GdkPixbuf *cached) {
+    return gdk_pixbuf_get_option(cached, KEY_LAST_MODIFIED);
+}
+
+static gint compare_entry_mtime(gconstpointer a, gconstpointer b) {
+    const CacheEntry *entry_a = *(const CacheEntry **)a;
+    const CacheEntry *entry_b = *(const CacheEntry **)b;
+    return (entry_a->mtime > entry_b->mtime) - (entry_a->mtime < entry_b->mtime);
+}
+
+static void cache_entry_free(gpointer data) {
+    CacheEntry *entry = (CacheEntry *)data;
+    g_free(entry->path);
+    g_free(entry);
+}
+
+// Delete the least recently used files until the directory fits the budget
+static void evict_to_budget(gint64 budget) {
+    gchar *dir_path = cache_dir();
+    GDir *dir = g_dir_open(dir_path, 0, NULL);
+    if (!dir) {
+        g_free(dir_path);
+        return;
+    }
+
+    GPtrArray *entries = g_ptr_array_new_with_free_func(cache_entry_free);
+    gint64 total = 0;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    const gchar *name;
+
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        gchar *path = g_build_filename(dir_path, name, NULL);
+        GStatBuf st;
+        if (g_stat(path, &st) != 0) {
+            g_free(path);
+            continue;
+        }
+
+        if (g_str_has_suffix(name, ".tmp")) {
+            if (now - (gint64)st.st_mtime > STALE_TEMP_SECONDS) g_unlink(path);
+            g_free(path);
+            continue;
+        }
+        if (!g_str_has_suffix(name, ".png")) {
+            g_free(path);
+            continue;
+        }
+
+        CacheEntry *entry = g_new0(CacheEntry, 1);
+        entry->path = path;
+        entry->size = st.st_size;
+        entry->mtime = st.st_mtime;
+        total += entry->size;
+        g_ptr_array_add(entries, entry);
+    }
+    g_dir_close(dir);
+
+    if (total > budget) {
+        g_ptr_array_sort(entries, compare_entry_mtime);
+        for (guint i = 0; i < entries->len && total > budget; i++) {
+            CacheEntry *entry = g_ptr_array_index(entries, i);
+            if (g_unlink(entry->path) == 0) total -= entry->size;
+        }
+    }
+
+    g_ptr_array_free(entries, TRUE);
+    g_free(dir_path);
+}
+
+void art_cache_store(const gchar *art_url, gint size, GdkPixbuf *pixbuf,
+                     const gchar *etag, const gchar *last_modified) {
+    gint budget_mb = g_atomic_int_get(&cache_budget_mb);
+    if (budget_mb == 0 || !pixbuf) return;
+
+    gchar *dir = cache_dir();
+    g_mkdir_with_parents(dir, 0755);
+    g_free(dir);
+
+    // Write to a temp file and rename, so readers never see a partial PNG
+    gchar *path = cache_path(art_url, size);
+    gchar *temp_path = g_strdup_printf("%s.%p.tmp", path, (void *)g_thread_self());
+    GError *error = NULL;
+
+    gchar *checked = g_strdup_printf("%" G_GINT64_FORMAT, g_get_real_time() / G_USEC_PER_SEC);
+    gchar *keys[4] = { (gchar *)KEY_CHECKED, NULL, NULL, NULL };
+    gchar *values[4] = { checked, NULL, NULL, NULL };
+    gint n = 1;
+    if (etag) {
+        keys[n] = (gchar *)KEY_ETAG;
+        values[n++] = (gchar *)etag;
+    }
+    if (last_modified) {
+        keys[n] = (gchar *)KEY_LAST_MODIFIED;
+        values[n++] = (gchar *)last_modified;
+    }
+
+    if (gdk_pixbuf_savev(pixbuf, temp_path, "png", keys, values, &error) &&
+        g_rename(temp_path, path) == 0) {
+        g_mutex_lock(&evict_lock);
+        evict_to_budget((gint64)budget_mb * 1024 * 1024);
+        g_mutex_unlock(&evict_lock);
+    } else {
+        if (error) {
+            g_printerr("Failed to cache album art: %s\n", error->message);
+            g_error_free(error);
+        }
+        g_unlink(temp_path);
+    }
+
+    g_free(checked);
+    g_free(temp_path);
+    g_free(path);
+}
@@ -0,0 +1,59 @@
+#ifndef ART_CACHE_H
+#define ART_CACHE_H
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#define ART_CACHE_FRESH_SECONDS (7 * 24 * 60 * 60)
+
+/**
+ * Album Art Disk Cache
+ *
+ * Remote album art, already scaled to the size it is shown at, stored as
+ * PNG under $XDG_CACHE_HOME/hyprwave/art. Files are content-addressed:
+ * the name is the SHA-256 of the URL plus the target size, so repeat plays
+ * and restarts skip both the download and the full-size decode.
+ *
+ * The directory is kept under a size budget with LRU eviction (a hit
+ * refreshes the file's mtime; the oldest files go first).
+ *
+ * Each PNG also carries the server's validators (ETag, Last-Modified) and
+ * the time it was last confirmed, as text chunks. Entries younger than
+ * ART_CACHE_FRESH_SECONDS are used as-is; older ones are revalidated with
+ * a conditional request before reuse.
+ *
+ * Thread-safe: called from the art loading workers.
+ */
+
+/**
+ * Set the size budget.
+ *
+ * @param megabytes Maximum cache size in MiB, 0 disables the cache
+ */
+void art_cache_set_budget_mb(gint megabytes);
+
+/**
+ * Look up pre-scaled art.
+ *
+ * @return A new pixbuf, or NULL on a miss (or if the cache is disabled)
+ */
+GdkPixbuf* art_cache_lookup(const gchar *art_url, gint size);
+
+/**
+ * TRUE if a cached pixbuf was confirmed recently enough to skip revalidation.
+ */
+gboolean art_cache_is_fresh(GdkPixbuf *cached);
+
+/**
+ * Validators stored with a cached pixbuf, or NULL.
+ */
+const gchar* art_cache_get_etag(GdkPixbuf *cached);
+const gchar* art_cache_get_last_modified(GdkPixbuf *cached);
+
+/**
+ * Store pre-scaled art with its validators (either may be NULL), mark it
+ * fresh, and evict least recently used files over budget.
+ */
+void art_cache_store(const gchar *art_url, gint size, GdkPixbuf *pixbuf,
+                     const gchar *etag, const gchar *last_modified);
+
+#endif // ART_CACHE_H
@@ -0,0 +1,115 @@
+#include "art_fetch.h"
+#include <libsoup/soup.h>
+
+#define ART_FETCH_TIMEOUT_SECONDS 10      // Connect and per-read timeout
+#define ART_FETCH_IDLE_SECONDS 90         // Keep-alive between tracks
+#define ART_FETCH_MAX_CONNS 4             // Concurrent fetches, all hosts
+#define ART_FETCH_MAX_CONNS_PER_HOST 2
+#define ART_FETCH_CHUNK 16384
+
+static SoupSession* get_session(void) {
+    static SoupSession *session = NULL;
+    static gsize initialized = 0;
+
+    // Requests beyond max-conns wait in the session's queue for a free connection
+    if (g_once_init_enter(&initialized)) {
+        session = g_object_new(SOUP_TYPE_SESSION,
+                               "timeout", ART_FETCH_TIMEOUT_SECONDS,
+                               "idle-timeout", ART_FETCH_IDLE_SECONDS,
+                               "max-conns", ART_FETCH_MAX_CONNS,
+                               "max-conns-per-host", ART_FETCH_MAX_CONNS_PER_HOST,
+                               "user-agent", "hyprwave ",
+                               NULL);
+        g_once_init_leave(&initialized, 1);
+    }
+    return session;
+}
+
+// Read the whole body, giving up as soon as it outgrows the cap
+static GBytes* read_body(GInputStream *stream, GCancellable *cancellable, GError **error) {
+    GByteArray *buffer = g_byte_array_new();
+    guint8 chunk[ART_FETCH_CHUNK];
+
+    for (;;) {
+        gssize n = g_input_stream_read(stream, chunk, sizeof(chunk), cancellable, error);
+        if (n < 0) {
+            g_byte_array_unref(buffer);
+            return NULL;
+        }
+        if (n == 0) break;
+
+        if (buffer->len + (gsize)n > ART_FETCH_MAX_BYTES) {
+            g_set_error(error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE,
+                        "Album art exceeds %d bytes", ART_FETCH_MAX_BYTES);
+            g_byte_array_unref(buffer);
+            return NULL;
+        }
+        g_byte_array_append(buffer, chunk, (guint)n);
+    }
+
+    return g_byte_array_free_to_bytes(buffer);
+}
+
+ArtFetchStatus art_fetch_http(const gchar *url, const gchar *etag, const gchar *last_modified,
+                              GCancellable *cancellable, ArtFetchResponse *response,
+                              GError **error) {
+    SoupMessage *message = soup_message_new(SOUP_METHOD_GET, url);
+    if (!message) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid art URL: %s", url);
+        return ART_FETCH_FAILED;
+    }
+
+    SoupMessageHeaders *request_headers = soup_message_get_request_headers(message);
+    if (etag) soup_message_headers_replace(request_headers, "If-None-Match", etag);
+    if (last_modified) soup_message_headers_replace(request_headers, "If-Modified-Since", last_modified);
+
+    GInputStream *stream = soup_session_send(get_session(), message, cancellable, error);
+    if (!stream) {
+        g_object_unref(message);
+        return ART_FETCH_FAILED;
+    }
+
+    ArtFetchStatus result = ART_FETCH_FAILED;
+    guint status = soup_message_get_status(message);
+    SoupMessageHeaders *response_headers = soup_message_get_response_headers(message);
+
+    if (status == SOUP_STATUS_NOT_MODIFIED && (etag || last_modified)) {
+        result = ART_FETCH_NOT_MODIFIED;
+    } else if (SOUP_STATUS_IS_SUCCESSFUL(status)) {
+        goffset length = soup_message_headers_get_content_length(response_headers);
+        if (length > ART_FETCH_MAX_BYTES) {
+            // Refuse before downloading anything
+            g_set_error(error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE,
+                        "Album art is %" G_GOFFSET_FORMAT " bytes (limit %d)",
+                        length, ART_FETCH_MAX_BYTES);
+        } else {
+            GBytes *body = read_body(stream, cancellable, error);
+            if (body) {
+                response->body = body;
+                response->etag = g_strdup(soup_message_headers_get_one(response_headers, "ETag"));
+                response->last_modified =
+                    g_strdup(soup_message_headers_get_one(response_headers, "Last-Modified"));
+                result = ART_FETCH_OK;
+            }
+        }
+    } else {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "HTTP %u fetching %s", status, url);
+    }
+
+    // A fully read body returns the connection to the keep-alive pool;
+    // an abandoned one is closed instead
+    g_input_stream_close(stream, NULL, NULL);
+    g_object_unref(stream);
+    g_object_unref(message);
+    return result;
+}
+
+void art_fetch_response_clear(ArtFetchResponse *response) {
+    g_clear_pointer(&response->body, g_bytes_unref);
+    g_clear_pointer(&response->etag, g_free);
+    g_clear_pointer(&response->last_modified, g_free);
+}
+
+void art_fetch_set_timeout(guint seconds) {
+    g_object_set(get_session(), "timeout", seconds, NULL);
+}
@@ -0,0 +1,63 @@
+#ifndef ART_FETCH_H
+#define ART_FETCH_H
+
+#include <gio/gio.h>
+
+/**
+ * Album Art HTTP Fetcher
+ *
+ * Downloads remote album art through one shared libsoup session, so the
+ * connection to a streaming service's CDN is kept alive across tracks
+ * instead of being re-established (DNS, TCP, TLS) for every cover.
+ *
+ * Every request is bounded: connect/read timeouts, a cap on the response
+ * size (checked against Content-Length and again while reading), and a
+ * small connection limit that queues concurrent fetches. Callers can pass
+ * the validators of a cached copy to revalidate it with a conditional GET.
+ *
+ * Any http:// URL works, so a local stand-in server is enough to exercise
+ * the timeouts, the size guard and 304 handling.
+ *
+ * Blocking; call from worker threads only.
+ */
+
+#define ART_FETCH_MAX_BYTES (8 * 1024 * 1024)  // Larger responses are refused
+
+typedef enum {
+    ART_FETCH_FAILED,
+    ART_FETCH_OK,            // body holds the new image
+    ART_FETCH_NOT_MODIFIED   // 304: the cached copy is still current
+} ArtFetchStatus;
+
+typedef struct {
+    GBytes *body;            // Response body (ART_FETCH_OK only)
+    gchar *etag;             // Validators to store with the result, or NULL
+    gchar *last_modified;
+} ArtFetchResponse;
+
+/**
+ * Fetch an image over HTTP(S).
+ *
+ * @param url http:// or https:// URL
+ * @param etag ETag of a cached copy, or NULL
+ * @param last_modified Last-Modified of a cached copy, or NULL
+ * @param cancellable Aborts the request
+ * @param response Filled in on success; clear with art_fetch_response_clear()
+ * @param error Set on ART_FETCH_FAILED
+ */
+ArtFetchStatus art_fetch_http(const gchar *url, const gchar *etag, const gchar *last_modified,
+                              GCancellable *cancellable, ArtFetchResponse *response,
+                              GError **error);
+
+/**
+ * Release the fields of a response (the struct itself is not freed).
+ */
+void art_fetch_response_clear(ArtFetchResponse *response);
+
+/**
+ * Override the connect/read timeout (default 10 s). Must be called
+ * before the first fetch; lets tests hit the timeout quickly.
+ */
+void art_fetch_set_timeout(guint seconds);
+
+#endif // ART_FETCH_H
@@ -0,0 +1,225 @@
+#include "audio_kernels.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AUDIO_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+typedef void (*DownmixStereoFunc)(const float *, gsize, float *, AudioStats *);
+typedef void (*AnalyzeMonoFunc)(const float *, gsize, AudioStats *);
+
+static DownmixStereoFunc downmix_stereo_impl = audio_downmix_stereo_scalar;
+static AnalyzeMonoFunc analyze_mono_impl = audio_analyze_mono_scalar;
+static const gchar *kernels_name = "scalar";
+
+// ========================================
+// SCALAR (reference)
+// ========================================
+
+void audio_downmix_stereo_scalar(const float *interleaved, gsize n_frames,
+                                 float *mono, AudioStats *stats) {
+    float peak = 0.0f;
+    float sum_sq = 0.0f;
+
+    for (gsize i = 0; i < n_frames; i++) {
+        float m = (interleaved[2 * i] + interleaved[2 * i + 1]) * 0.5f;
+        mono[i] = m;
+        float a = fabsf(m);
+        if (a > peak) peak = a;
+        sum_sq += m * m;
+    }
+
+    stats->peak = peak;
+    stats->sum_sq = sum_sq;
+}
+
+void audio_analyze_mono_scalar(const float *samples, gsize n_samples, AudioStats *stats) {
+    float peak = 0.0f;
+    float sum_sq = 0.0f;
+
+    for (gsize i = 0; i < n_samples; i++) {
+        float a = fabsf(samples[i]);
+        if (a > peak) peak = a;
+        sum_sq += samples[i] * samples[i];
+    }
+
+    stats->peak = peak;
+    stats->sum_sq = sum_sq;
+}
+
+#ifdef AUDIO_KERNELS_X86
+
+// ========================================
+// SSE2 (baseline on x86-64)
+// ========================================
+
+static inline float hmax_ps(__m128 v) {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(v);
+}
+
+static inline float hsum_ps(__m128 v) {
+    v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(v);
+}
+
+static void downmix_stereo_sse2(const float *interleaved, gsize n_frames,
+                                float *mono, AudioStats *stats) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vpeak = _mm_setzero_ps();
+    __m128 vsum = _mm_setzero_ps();
+
+    gsize i = 0;
+    for (; i + 4 <= n_frames; i += 4) {
+        __m128 a = _mm_loadu_ps(interleaved + 2 * i);      // L0 R0 L1 R1
+        __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);  // L2 R2 L3 R3
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 m = _mm_mul_ps(_mm_add_ps(left, right), half);
+
+        _mm_storeu_ps(mono + i, m);
+        vpeak = _mm_max_ps(vpeak, _mm_and_ps(m, abs_mask));
+        vsum = _mm_add_ps(vsum, _mm_mul_ps(m, m));
+    }
+
+    AudioStats tail;
+    audio_downmix_stereo_scalar(interleaved + 2 * i, n_frames - i, mono + i, &tail);
+
+    stats->peak = MAX(hmax_ps(vpeak), tail.peak);
+    stats->sum_sq = hsum_ps(vsum) + tail.sum_sq;
+}
+
+static void analyze_mono_sse2(const float *samples, gsize n_samples, AudioStats *stats) {
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vpeak = _mm_setzero_ps();
+    __m128 vsum = _mm_setzero_ps();
+
+    gsize i = 0;
+    for (; i + 4 <= n_samples; i += 4) {
+        __m128 s = _mm_loadu_ps(samples + i);
+        vpeak = _mm_max_ps(vpeak, _mm_and_ps(s, abs_mask));
+        vsum = _mm_add_ps(vsum, _mm_mul_ps(s, s));
+    }
+
+    AudioStats tail;
+    audio_analyze_mono_scalar(samples + i, n_samples - i, &tail);
+
+    stats->peak = MAX(hmax_ps(vpeak), tail.peak);
+    stats->sum_sq = hsum_ps(vsum) + tail.sum_sq;
+}
+
+// ========================================
+// AVX2 (selected at runtime)
+// ========================================
+
+__attribute__((target("avx2")))
+static inline __m128 fold_max_256(__m256 v) {
+    return _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+__attribute__((target("avx2")))
+static inline __m128 fold_add_256(__m256 v) {
+    return _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+__attribute__((target("avx2")))
+static void downmix_stereo_avx2(const float *interleaved, gsize n_frames,
+                                float *mono, AudioStats *stats) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vpeak = _mm256_setzero_ps();
+    __m256 vsum = _mm256_setzero_ps();
+
+    gsize i = 0;
+    for (; i + 8 <= n_frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(interleaved + 2 * i);      // L0 R0 .. L3 R3
+        __m256 b = _mm256_loadu_ps(interleaved + 2 * i + 8);  // L4 R4 .. L7 R7
+        // In-lane shuffles yield L0 L1 L4 L5 | L2 L3 L6 L7 (same for R)
+        __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 m = _mm256_mul_ps(_mm256_add_ps(left, right), half);
+        // Restore frame order: 64-bit lanes 0 2 1 3
+        m = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(m), _MM_SHUFFLE(3, 1, 2, 0)));
+
+        _mm256_storeu_ps(mono + i, m);
+        vpeak = _mm256_max_ps(vpeak, _mm256_and_ps(m, abs_mask));
+        vsum = _mm256_add_ps(vsum, _mm256_mul_ps(m, m));
+    }
+
+    AudioStats tail;
+    downmix_stereo_sse2(interleaved + 2 * i, n_frames - i, mono + i, &tail);
+
+    stats->peak = MAX(hmax_ps(fold_max_256(vpeak)), tail.peak);
+    stats->sum_sq = hsum_ps(fold_add_256(vsum)) + tail.sum_sq;
+}
+
+__attribute__((target("avx2")))
+static void analyze_mono_avx2(const float *samples, gsize n_samples, AudioStats *stats) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vpeak = _mm256_setzero_ps();
+    __m256 vsum = _mm256_setzero_ps();
+
+    gsize i = 0;
+    for (; i + 8 <= n_samples; i += 8) {
+        __m256 s = _mm256_loadu_ps(samples + i);
+        vpeak = _mm256_max_ps(vpeak, _mm256_and_ps(s, abs_mask));
+        vsum = _mm256_add_ps(vsum, _mm256_mul_ps(s, s));
+    }
+
+    AudioStats tail;
+    analyze_mono_sse2(samples + i, n_samples - i, &tail);
+
+    stats->peak = MAX(hmax_ps(fold_max_256(vpeak)), tail.peak);
+    stats->sum_sq = hsum_ps(fold_add_256(vsum)) + tail.sum_sq;
+}
+
+#endif // AUDIO_KERNELS_X86
+
+gboolean audio_kernels_select(const gchar *name) {
+    if (g_strcmp0(name, "scalar") == 0) {
+        downmix_stereo_impl = audio_downmix_stereo_scalar;
+        analyze_mono_impl = audio_analyze_mono_scalar;
+        kernels_name = "scalar";
+        return TRUE;
+    }
+#ifdef AUDIO_KERNELS_X86
+    __builtin_cpu_init();
+    if (g_strcmp0(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        downmix_stereo_impl = downmix_stereo_avx2;
+        analyze_mono_impl = analyze_mono_avx2;
+        kernels_name = "avx2";
+        return TRUE;
+    }
+    if (g_strcmp0(name, "sse2") == 0) {
+        downmix_stereo_impl = downmix_stereo_sse2;
+        analyze_mono_impl = analyze_mono_sse2;
+        kernels_name = "sse2";
+        return TRUE;
+    }
+#endif
+    return FALSE;
+}
+
+void audio_kernels_init(void) {
+    // Best first; scalar always succeeds
+    if (!audio_kernels_select("avx2") && !audio_kernels_select("sse2")) {
+        audio_kernels_select("scalar");
+    }
+}
+
+const gchar* audio_kernels_name(void) {
+    return kernels_name;
+}
+
+void audio_downmix_stereo(const float *interleaved, gsize n_frames,
+                          float *mono, AudioStats *stats) {
+    downmix_stereo_impl(interleaved, n_frames, mono, stats);
+}
+
+void audio_analyze_mono(const float *samples, gsize n_samples, AudioStats *stats) {
+    analyze_mono_impl(samples, n_samples, stats);
+}
@@ -0,0 +1,66 @@
+#ifndef AUDIO_KERNELS_H
+#define AUDIO_KERNELS_H
+
+#include <glib.h>
+
+/**
+ * Vectorized Sample Kernels
+ *
+ * Downmix, absolute peak and sum-of-squares over float PCM in a single pass.
+ * These run on the PipeWire RT thread for every quantum, so they never
+ * allocate and never branch per sample.
+ *
+ * On x86-64 an SSE2 or AVX2 implementation is selected at runtime by
+ * audio_kernels_init(); other architectures use the portable scalar path.
+ * The mono output is bit-identical across implementations; peak and
+ * sum_sq differ only by float summation order.
+ */
+
+typedef struct {
+    float peak;      // Largest |sample| of the mono signal
+    float sum_sq;    // Sum of squared mono samples
+} AudioStats;
+
+/**
+ * Select the fastest kernels for this CPU. Safe to call more than once;
+ * must be called before the first RT callback.
+ */
+void audio_kernels_init(void);
+
+/**
+ * Force a kernel set by name ("avx2", "sse2" or "scalar"), e.g. to test
+ * each one against the reference.
+ *
+ * @return FALSE if this CPU or build cannot run it (selection unchanged)
+ */
+gboolean audio_kernels_select(const gchar *name);
+
+/**
+ * Name of the active kernel set ("avx2", "sse2" or "scalar").
+ */
+const gchar* audio_kernels_name(void);
+
+/**
+ * Downmix interleaved stereo to mono ((L + R) / 2) and measure it.
+ *
+ * @param interleaved n_frames * 2 samples
+ * @param n_frames Number of stereo frames
+ * @param mono Output, n_frames samples
+ * @param stats Peak and sum of squares of the mono output
+ */
+void audio_downmix_stereo(const float *interleaved, gsize n_frames,
+                          float *mono, AudioStats *stats);
+
+/**
+ * Measure a mono buffer without copying it.
+ */
+void audio_analyze_mono(const float *samples, gsize n_samples, AudioStats *stats);
+
+/**
+ * Portable reference implementations (always scalar).
+ */
+void audio_downmix_stereo_scalar(const float *interleaved, gsize n_frames,
+                                 float *mono, AudioStats *stats);
+void audio_analyze_mono_scalar(const float *samples, gsize n_samples, AudioStats *stats);
+
+#endif // AUDIO_KERNELS_H
@@ -60,13 +60,31 @@ LayoutConfig* layout_load_config(void) {
             "# Set to 0 to disable auto-activation (visualizer only shows on demand)\n"
             "idle_timeout = 30\n"
             "\n"
+            "# FFT size for the spectrum analyzer: 256, 512, 1024, 2048, 4096 or 8192\n"
+            "# Larger sizes resolve bass better but react more slowly\n"
+            "fft_size = 2048\n"
+            "\n"
+            "# Capture source: 'stream' (only the player) or 'sink' (everything on its output)\n"
+            "capture_source = stream\n"
+            "\n"
+            "# Capture budget: mono audio, analyzed once per frame instead of per quantum\n"
+            "capture_budget = true\n"
+            "\n"
+            "# Capture sample rate in Hz (0 = sink's native rate, no resampling)\n"
+            "capture_rate = 0\n"
+            "\n"
             "[VerticalDisplay]\n"
             "# Enable/disable vertical display (vertical layout only)\n"
             "enabled = true\n"
             "\n"
             "# Idle timeout in seconds before vertical display appears\n"
             "# Set to 0 to disable auto-activation (display only shows on demand)\n"
-            "idle_timeout = 5\n";
+            "idle_timeout = 5\n"
+            "\n"
+            "[AlbumArt]\n"
+            "# Disk cache for downloaded album art in MB (0 = disabled)\n"
+            "# Stored pre-scaled in ~/.cache/hyprwave/art, least recently used art is evicted first\n"
+            "cache_size_mb = 50\n";
 
         g_file_set_contents(config_file, default_config, -1, NULL);
         g_print("Created default config at: %s\n", config_file);
@@ -85,8 +103,13 @@ LayoutConfig* layout_load_config(void) {
     config->theme = g_strdup("light");
     config->visualizer_enabled = TRUE;
     config->visualizer_idle_timeout = 30;
+    config->visualizer_fft_size = 2048;
+    config->visualizer_capture_stream = TRUE;
+    config->visualizer_capture_budget = TRUE;
+    config->visualizer_capture_rate = 0;
     config->vertical_display_enabled = TRUE;
     config->vertical_display_scroll_interval = 5;
+    config->album_art_cache_mb = 50;
     config->player_preference = NULL;
     config->player_preference_count = 0;
 
@@ -181,6 +204,40 @@ LayoutConfig* layout_load_config(void) {
             if (config->visualizer_idle_timeout < 0) config->visualizer_idle_timeout = 0;
         } else {
             g_error_free(error);
+            error = NULL;
+        }
+
+        gint viz_fft_size = g_key_file_get_integer(keyfile, "Visualizer", "fft_size", &error);
+        if (!error) {
+            config->visualizer_fft_size = viz_fft_size;
+        } else {
+            g_error_free(error);
+            error = NULL;
+        }
+
+        gchar *viz_source = g_key_file_get_string(keyfile, "Visualizer", "capture_source", &error);
+        if (!error) {
+            config->visualizer_capture_stream = g_ascii_strcasecmp(g_strstrip(viz_source), "sink") != 0;
+            g_free(viz_source);
+        } else {
+            g_error_free(error);
+            error = NULL;
+        }
+
+        gboolean viz_budget = g_key_file_get_boolean(keyfile, "Visualizer", "capture_budget", &error);
+        if (!error) {
+            config->visualizer_capture_budget = viz_budget;
+        } else {
+            g_error_free(error);
+            error = NULL;
+        }
+
+        gint viz_rate = g_key_file_get_integer(keyfile, "Visualizer", "capture_rate", &error);
+        if (!error) {
+            config->visualizer_capture_rate = viz_rate < 0 ? 0 : viz_rate;
+        } else {
+            g_error_free(error);
+            error = NULL;
         }
     
     
@@ -196,6 +253,15 @@ LayoutConfig* layout_load_config(void) {
         if (!error) {
             config->vertical_display_scroll_interval = vert_timeout;
             if (config->vertical_display_scroll_interval < 0) config->vertical_display_scroll_interval = 0;
+        } else {
+            g_error_free(error);
+            error = NULL;
+        }
+
+        // Load AlbumArt section (optional)
+        gint art_cache_mb = g_key_file_get_integer(keyfile, "AlbumArt", "cache_size_mb", &error);
+        if (!error) {
+            config->album_art_cache_mb = art_cache_mb < 0 ? 0 : art_cache_mb;
         } else {
             g_error_free(error);
         }
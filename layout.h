@@ -22,8 +22,13 @@ typedef struct {
     gchar *theme;  // "light" or "dark" (Hi-Fi feature)
     gboolean visualizer_enabled;
     gint visualizer_idle_timeout;
+    gint visualizer_fft_size;              // FFT length for the spectrum (power of two)
+    gboolean visualizer_capture_stream;    // Capture only the player's stream (not its sink)
+    gboolean visualizer_capture_budget;    // Mono capture in frame-sized quanta
+    gint visualizer_capture_rate;          // Capture rate in Hz (0 = native)
     gboolean vertical_display_enabled;
     gint vertical_display_scroll_interval;
+    gint album_art_cache_mb;               // Disk cache budget for remote art (0 = disabled)
     gchar **player_preference;             // Array of preferred players (e.g., ["spotify", "vlc"])
     gint player_preference_count;          // Number of preferred players
     gint button_size;                      // Button size (xs=20, s=40, m=70, l=100)
@@ -9,9 +9,14 @@
 #include "paths.h"
 #include "notification.h"
 #include "art.h"
+#include "art_cache.h"
 #include "volume.h"
 #include "visualizer.h"
 #include "pipewire_volume.h"
+#include "pipewire_service.h"
+#include "mpris_player.h"
+#include "player_registry.h"
+#include "track_info.h"
 #include "vertical_display.h"
 
 typedef struct {
@@ -36,14 +41,17 @@ typedef struct {
     gboolean can_seek;                 // Hi-Fi: True if player supports seeking
     GDBusProxy *mpris_proxy;
     gchar *current_player;
-    guint update_timer;
     LayoutConfig *layout;
     NotificationState *notification;
     VolumeState *volume;
-    gchar *last_track_id;
-    gchar *last_title;                 // Hi-Fi: Fallback for track change detection
-    gchar *current_track_id;           // Hi-Fi: For seek operations
-    gint64 current_length;             // Hi-Fi: Track length in microseconds
+    TrackInfo *track;                  // Parsed Metadata (what the widgets show), NULL after reset
+
+    // Position is extrapolated locally and only re-read on sync points
+    // (player switch, track change, resume, Seeked)
+    gint64 position_base;              // Last known position (µs)
+    gint64 position_base_time;         // Monotonic time position_base was valid at
+    gdouble playback_rate;             // MPRIS Rate (1.0 = normal speed)
+    guint position_tick_id;            // Frame-clock tick on progress_bar while playing
     guint notification_timer;
     gchar *pending_title;
     gchar *pending_artist;
@@ -54,9 +62,6 @@ typedef struct {
     GtkWidget *next_btn;
     GtkWidget *expand_btn;
     // Hi-Fi: Multi-player support
-    gchar **players;                   // Array of MPRIS player D-Bus names
-    gint player_count;
-    gint current_player_index;
     gchar *player_display_name;        // Human-readable name from Identity
     gboolean suppress_notification;    // Suppress during player switch
 
@@ -69,11 +74,17 @@ typedef struct {
     gdouble button_fade_opacity;
 
     // Player monitoring
-    guint dbus_watch_id;               // D-Bus name watcher
     guint reconnect_timer;             // Timer for reconnection attempts
+    GCancellable *resolve_cancellable; // In-flight player -> audio stream lookup
+    GCancellable *player_cancellable;  // In-flight proxy creation for switch_to_player
 } AppState;
 
 static void update_position(AppState *state);
+static void update_position_ticking(AppState *state);
+static void on_change_value(GtkRange *range, GtkScrollType scroll, gdouble value, gpointer user_data);
+static void on_player_signal(GDBusProxy *proxy, const gchar *sender_name,
+                             const gchar *signal_name, GVariant *parameters,
+                             gpointer user_data);
 static void update_metadata(AppState *state);
 static void update_playback_status(AppState *state);
 static void on_expand_clicked(GtkButton *button, gpointer user_data);
@@ -85,7 +96,7 @@ static void start_visualizer_if_expanded(AppState *state);
 static void stop_visualizer_if_collapsed(AppState *state);
 
 // Hi-Fi: Multi-player functions
-static void load_available_players(AppState *state);
+static void update_player_selector(AppState *state);
 static void switch_to_player(AppState *state, const gchar *bus_name);
 static void cycle_player(AppState *state, gboolean forward);
 static gchar* load_preferred_player(void);
@@ -101,247 +112,128 @@ static void find_active_player(AppState *state);
 static AppState *global_state = NULL;
 
 // ========================================
-// Hi-Fi: PLAYER FILTERING
+// Hi-Fi: PLAYER SWITCHING
 // ========================================
 
-// Check if a D-Bus name should be excluded from player list
-static gboolean is_excluded_player(const gchar *name) {
-    // Exclude playerctld (it's a proxy, not a real player)
-    if (g_str_has_suffix(name, ".playerctld")) return TRUE;
-
-    // Exclude common browsers (poor MPRIS metadata)
-    const gchar *excluded[] = {
-        ".firefox", ".chromium", ".chrome", ".brave",
-        ".vivaldi", ".opera", ".edge", NULL
-    };
+// Refresh the player selector label from the registry (no D-Bus traffic)
+static void update_player_selector(AppState *state) {
+    if (!state->player_label) return;
 
-    for (const gchar **ex = excluded; *ex; ex++) {
-        if (g_str_has_suffix(name, *ex)) return TRUE;
+    if (state->player_display_name) {
+        gtk_label_set_text(GTK_LABEL(state->player_label), state->player_display_name);
+    } else if (player_registry_get_count() > 0) {
+        gtk_label_set_text(GTK_LABEL(state->player_label), "Click to switch");
+    } else {
+        gtk_label_set_text(GTK_LABEL(state->player_label), "No players");
     }
-    return FALSE;
 }
 
-// Check if chromium-based player is allowed (e.g., Cider, tidal-hifi)
-// For chromium.instance* names, check the Identity property
-static gboolean is_allowed_chromium_player(const gchar *name) {
-    // Allow specific names directly in the D-Bus name
-    const gchar *allowed[] = {
-        "Cider", "tidal", "hifi", "qobuz", "spotify", "Plexamp", "roon", NULL
-    };
-
-    for (const gchar **a = allowed; *a; a++) {
-        if (g_strstr_len(name, -1, *a)) return TRUE;
-    }
-
-    // If it's a chromium instance, check the Identity property
-    if (g_strstr_len(name, -1, "chromium.instance") ||
-        g_strstr_len(name, -1, "chrome.instance")) {
-        // Fetch Identity property to check if it's an allowed app
-        GDBusProxy *proxy = g_dbus_proxy_new_for_bus_sync(
-            G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
-            name, "/org/mpris/MediaPlayer2",
-            "org.mpris.MediaPlayer2", NULL, NULL);
-
-        if (proxy) {
-            GVariant *identity = g_dbus_proxy_get_cached_property(proxy, "Identity");
-            if (identity) {
-                const gchar *id_str = g_variant_get_string(identity, NULL);
-                gboolean allowed_app = FALSE;
-
-                // Check if Identity contains allowed app names
-                for (const gchar **a = allowed; *a; a++) {
-                    if (g_strstr_len(id_str, -1, *a)) {
-                        allowed_app = TRUE;
-                        break;
-                    }
-                }
-
-                g_variant_unref(identity);
-                g_object_unref(proxy);
-                return allowed_app;
-            }
-            g_object_unref(proxy);
-        }
-        return FALSE;  // Unknown chromium instance, filter it
-    }
-
-    // Block generic browser names
-    if (g_strstr_len(name, -1, "chromium") ||
-        g_strstr_len(name, -1, "chrome") ||
-        g_strstr_len(name, -1, "firefox")) {
-        return FALSE;
-    }
-
-    return TRUE;  // Allow non-chromium players
+// Save preferred player to config file
+static void save_preferred_player(const gchar *bus_name) {
+    gchar *config_dir = g_build_filename(g_get_user_config_dir(), "hyprwave", NULL);
+    gchar *pref_file = g_build_filename(config_dir, "preferred_player", NULL);
+    g_mkdir_with_parents(config_dir, 0755);
+    g_file_set_contents(pref_file, bus_name, -1, NULL);
+    g_free(pref_file);
+    g_free(config_dir);
 }
 
-// ========================================
-// Hi-Fi: PLAYER SWITCHING
-// ========================================
-
-// Load all available MPRIS players from D-Bus
-static void load_available_players(AppState *state) {
-    // Free previous list
-    if (state->players) {
-        g_strfreev(state->players);
-        state->players = NULL;
+// Load preferred player from config file
+static gchar* load_preferred_player(void) {
+    gchar *pref_file = g_build_filename(g_get_user_config_dir(), "hyprwave", "preferred_player", NULL);
+    gchar *contents = NULL;
+    if (g_file_get_contents(pref_file, &contents, NULL, NULL)) {
+        g_strstrip(contents);
     }
-    state->player_count = 0;
+    g_free(pref_file);
+    return contents;
+}
 
+// Player audio stream resolved on a worker thread
+static void on_player_resolved(GObject *source, GAsyncResult *result, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
     GError *error = NULL;
-    GDBusProxy *dbus_proxy = g_dbus_proxy_new_for_bus_sync(
-        G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
-        "org.freedesktop.DBus", "/org/freedesktop/DBus",
-        "org.freedesktop.DBus", NULL, &error);
+    PwPlayerTarget *target = pw_resolve_player_finish(result, &error);
 
-    if (error) {
+    if (!target) {
+        // Superseded by a newer lookup
+        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            g_printerr("Failed to resolve player audio: %s\n", error->message);
+        }
         g_error_free(error);
         return;
     }
 
-    GVariant *result = g_dbus_proxy_call_sync(dbus_proxy, "ListNames",
-        NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
-
-    if (error) {
-        g_error_free(error);
-        g_object_unref(dbus_proxy);
+    // The player may have vanished while the lookup ran
+    if (g_strcmp0(target->bus_name, state->current_player) != 0) {
+        pw_player_target_free(target);
         return;
     }
 
-    GVariantIter *iter;
-    g_variant_get(result, "(as)", &iter);
-
-    const gchar *name;
-    GPtrArray *player_arr = g_ptr_array_new();
-
-    while (g_variant_iter_loop(iter, "&s", &name)) {
-        if (g_str_has_prefix(name, "org.mpris.MediaPlayer2.") &&
-            !is_excluded_player(name) &&
-            is_allowed_chromium_player(name)) {
-            g_ptr_array_add(player_arr, g_strdup(name));
-        }
+    if (state->volume) {
+        volume_set_sink_input(state->volume, target->sink_input, target->volume);
     }
 
-    g_variant_iter_free(iter);
-    g_variant_unref(result);
-    g_object_unref(dbus_proxy);
-
-    g_ptr_array_add(player_arr, NULL);
-    state->players = (gchar **)g_ptr_array_free(player_arr, FALSE);
-
-    // Count players
-    state->player_count = 0;
-    for (gchar **p = state->players; *p; p++) state->player_count++;
-
-    // Find current player index
-    state->current_player_index = -1;
-    if (state->current_player && state->players) {
-        for (int i = 0; state->players[i]; i++) {
-            if (g_strcmp0(state->players[i], state->current_player) == 0) {
-                state->current_player_index = i;
-                break;
-            }
-        }
-    }
+    if (state->visualizer) {
+        visualizer_set_target(state->visualizer, target);
 
-    // Update player label
-    if (state->player_label) {
-        if (state->player_display_name) {
-            gtk_label_set_text(GTK_LABEL(state->player_label), state->player_display_name);
-        } else if (state->player_count > 0) {
-            gtk_label_set_text(GTK_LABEL(state->player_label), "Click to switch");
-        } else {
-            gtk_label_set_text(GTK_LABEL(state->player_label), "No players");
+        // Update visualizer box visibility if currently expanded
+        if (state->is_expanded && state->visualizer_box) {
+            gboolean has_target = state->visualizer->target_serial > 0 || state->visualizer->target_found;
+            gtk_widget_set_visible(state->visualizer_box, has_target);
         }
     }
-}
 
-// Save preferred player to config file
-static void save_preferred_player(const gchar *bus_name) {
-    gchar *config_dir = g_build_filename(g_get_user_config_dir(), "hyprwave", NULL);
-    gchar *pref_file = g_build_filename(config_dir, "preferred_player", NULL);
-    g_mkdir_with_parents(config_dir, 0755);
-    g_file_set_contents(pref_file, bus_name, -1, NULL);
-    g_free(pref_file);
-    g_free(config_dir);
+    pw_player_target_free(target);
 }
 
-// Load preferred player from config file
-static gchar* load_preferred_player(void) {
-    gchar *pref_file = g_build_filename(g_get_user_config_dir(), "hyprwave", "preferred_player", NULL);
-    gchar *contents = NULL;
-    if (g_file_get_contents(pref_file, &contents, NULL, NULL)) {
-        g_strstrip(contents);
+// Look up the current player's PID, sink-input and sink without blocking the UI.
+// A newer lookup cancels the previous one, so fast player cycling never applies stale results.
+static void resolve_player_audio(AppState *state) {
+    if (state->resolve_cancellable) {
+        g_cancellable_cancel(state->resolve_cancellable);
+        g_clear_object(&state->resolve_cancellable);
     }
-    g_free(pref_file);
-    return contents;
-}
+    if (!state->current_player) return;
 
-// Switch to a specific MPRIS player
-static void switch_to_player(AppState *state, const gchar *bus_name) {
-    if (!bus_name) return;
+    state->resolve_cancellable = g_cancellable_new();
+    pw_resolve_player_async(state->current_player, state->resolve_cancellable,
+                            on_player_resolved, state);
+}
 
-    // Disconnect from current player
+// Stop following the current player's Player proxy
+static void release_player_proxy(AppState *state) {
     if (state->mpris_proxy) {
+        g_signal_handlers_disconnect_by_func(state->mpris_proxy, on_properties_changed, state);
+        g_signal_handlers_disconnect_by_func(state->mpris_proxy, on_player_signal, state);
         g_object_unref(state->mpris_proxy);
         state->mpris_proxy = NULL;
     }
+    update_position_ticking(state);
+}
 
-    g_free(state->current_player);
-    state->current_player = g_strdup(bus_name);
-
-    GError *error = NULL;
-    state->mpris_proxy = g_dbus_proxy_new_for_bus_sync(
-        G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
-        bus_name, "/org/mpris/MediaPlayer2",
-        "org.mpris.MediaPlayer2.Player", NULL, &error);
-
-    if (error) {
-        g_printerr("Failed to connect to player: %s\n", error->message);
-        g_error_free(error);
-        g_free(state->current_player);
-        state->current_player = NULL;
-        return;
-    }
+// Point the UI at a player whose cached proxies are ready
+static void attach_player(AppState *state, MprisPlayer *player) {
+    const gchar *bus_name = player->bus_name;
 
+    state->mpris_proxy = g_object_ref(player->player_proxy);
     g_signal_connect(state->mpris_proxy, "g-properties-changed",
                      G_CALLBACK(on_properties_changed), state);
+    g_signal_connect(state->mpris_proxy, "g-signal",
+                     G_CALLBACK(on_player_signal), state);
 
-    // Get display name from Identity
-    GDBusProxy *player_proxy = g_dbus_proxy_new_for_bus_sync(
-        G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
-        bus_name, "/org/mpris/MediaPlayer2",
-        "org.mpris.MediaPlayer2", NULL, NULL);
-
+    // Display name and seeking support come from the proxies' property caches
     g_free(state->player_display_name);
-    const gchar *fallback_name = strrchr(bus_name, '.');
-    state->player_display_name = g_strdup(fallback_name ? fallback_name + 1 : "Unknown");
-
-    if (player_proxy) {
-        GVariant *identity = g_dbus_proxy_get_cached_property(player_proxy, "Identity");
-        if (identity) {
-            g_free(state->player_display_name);
-            state->player_display_name = g_strdup(g_variant_get_string(identity, NULL));
-            g_variant_unref(identity);
-        }
-        g_object_unref(player_proxy);
+    if (player->identity) {
+        state->player_display_name = g_strdup(player->identity);
+    } else {
+        const gchar *fallback_name = strrchr(bus_name, '.');
+        state->player_display_name = g_strdup(fallback_name ? fallback_name + 1 : "Unknown");
     }
+    state->can_seek = mpris_player_can_seek(player);
 
-    // Check seeking support
-    state->can_seek = FALSE;
-    GVariant *seek_res = g_dbus_proxy_call_sync(state->mpris_proxy,
-        "org.freedesktop.DBus.Properties.Get",
-        g_variant_new("(ss)", "org.mpris.MediaPlayer2.Player", "CanSeek"),
-        G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL);
-    if (seek_res) {
-        GVariant *val = NULL;
-        g_variant_get(seek_res, "(v)", &val);
-        if (val) {
-            state->can_seek = g_variant_get_boolean(val);
-            g_variant_unref(val);
-        }
-        g_variant_unref(seek_res);
-    }
+    // Identity is cached with the player's proxies: no D-Bus call per property change
+    gtk_label_set_text(GTK_LABEL(state->source_label), player->identity ? player->identity : "");
 
     // Update display and save preference
     if (state->player_label) {
@@ -356,43 +248,83 @@ static void switch_to_player(AppState *state, const gchar *bus_name) {
     update_metadata(state);
     update_playback_status(state);
     state->suppress_notification = FALSE;
+    update_position(state);
 
-    // Update volume control with new player (reinitializes PipeWire state)
+    // Volume uses MPRIS until the player's stream is resolved
     if (state->volume) {
         volume_update_player(state->volume, state->mpris_proxy, bus_name);
     }
 
-    // Update visualizer to capture this player's audio
-    if (state->visualizer) {
-        guint32 player_pid = pw_extract_pid_from_bus_name(bus_name);
-        visualizer_set_target_pid(state->visualizer, player_pid, bus_name);
+    // Find the player's audio stream for volume and visualizer off the main thread
+    resolve_player_audio(state);
+}
 
-        // Update visualizer box visibility if currently expanded
-        if (state->is_expanded && state->visualizer_box) {
-            gboolean has_target = state->visualizer->target_serial > 0 || state->visualizer->target_found;
-            gtk_widget_set_visible(state->visualizer_box, has_target);
+static void on_player_connected(GObject *source, GAsyncResult *result, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    GError *error = NULL;
+    MprisPlayer *player = mpris_player_get_finish(result, &error);
+
+    if (!player) {
+        // Superseded by another switch
+        if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            g_error_free(error);
+            return;
         }
+        g_printerr("Failed to connect to player: %s\n", error->message);
+        g_error_free(error);
+        g_free(state->current_player);
+        state->current_player = NULL;
+        return;
     }
+
+    attach_player(state, player);
+}
+
+// Switch to a specific MPRIS player
+static void switch_to_player(AppState *state, const gchar *bus_name) {
+    if (!bus_name) return;
+
+    // Disconnect from current player
+    release_player_proxy(state);
+    if (state->player_cancellable) {
+        g_cancellable_cancel(state->player_cancellable);
+        g_clear_object(&state->player_cancellable);
+    }
+
+    gchar *name = g_strdup(bus_name);  // bus_name may be current_player itself
+    g_free(state->current_player);
+    state->current_player = name;
+
+    // Cached players attach immediately; new ones once their proxies exist
+    MprisPlayer *player = mpris_player_lookup(name);
+    if (player) {
+        attach_player(state, player);
+        return;
+    }
+
+    state->player_cancellable = g_cancellable_new();
+    mpris_player_get_async(name, state->player_cancellable, on_player_connected, state);
 }
 
 static void cycle_player(AppState *state, gboolean forward) {
-    load_available_players(state);
+    guint count = player_registry_get_count();
 
-    if (!state->players || state->player_count == 0) {
+    if (count == 0) {
         g_print("No MPRIS players available\n");
         return;
     }
 
-    gint new_index;
-    if (state->current_player_index < 0) {
+    gint current_index = player_registry_index_of(state->current_player);
+    guint new_index;
+    if (current_index < 0) {
         new_index = 0;
     } else if (forward) {
-        new_index = (state->current_player_index + 1) % state->player_count;
+        new_index = (current_index + 1) % count;
     } else {
-        new_index = (state->current_player_index - 1 + state->player_count) % state->player_count;
+        new_index = (current_index - 1 + count) % count;
     }
 
-    switch_to_player(state, state->players[new_index]);
+    switch_to_player(state, player_registry_get(new_index));
 }
 
 static void on_player_clicked(GtkGestureClick *gesture, gint n_press, gdouble x, gdouble y, gpointer user_data) {
@@ -799,22 +731,134 @@ static gboolean on_mouse_motion(GtkEventControllerMotion *controller,
     return FALSE;
 }
 
-static gint64 get_variant_as_int64(GVariant *value) {
-    if (value == NULL) return 0;
-    if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT64)) return g_variant_get_int64(value);
-    else if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT64)) return (gint64)g_variant_get_uint64(value);
-    else if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT32)) return (gint64)g_variant_get_int32(value);
-    else if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32)) return (gint64)g_variant_get_uint32(value);
-    else if (g_variant_is_of_type(value, G_VARIANT_TYPE_DOUBLE)) return (gint64)g_variant_get_double(value);
-    return 0;
+static gint64 track_length(AppState *state) {
+    return state->track ? state->track->length : 0;
 }
 
-static gboolean update_position_tick(gpointer user_data) {
+// Position now, extrapolated from the last sync point
+static gint64 get_extrapolated_position(AppState *state) {
+    gint64 position = state->position_base;
+    if (state->is_playing) {
+        gint64 elapsed = g_get_monotonic_time() - state->position_base_time;
+        position += (gint64)(elapsed * state->playback_rate);
+    }
+
+    if (position < 0) position = 0;
+    gint64 length = track_length(state);
+    if (length > 0 && position > length) {
+        position = length;
+    }
+    return position;
+}
+
+static gint64 get_vertical_display_position(gpointer user_data) {
+    return get_extrapolated_position((AppState *)user_data);
+}
+
+// New sync point: extrapolation continues from here
+static void set_position_base(AppState *state, gint64 position) {
+    state->position_base = position;
+    state->position_base_time = g_get_monotonic_time();
+
+    // The vertical display reads the extrapolated position itself; this keeps its length current
+    if (state->vertical_display) {
+        vertical_display_update_position(state->vertical_display, position, track_length(state));
+    }
+}
+
+static void render_position(AppState *state, gint64 position) {
+    gint64 length = track_length(state);
+    char time_str[32];
+    double fraction = 0.0;
+    gint64 pos_seconds = position / 1000000;
+
+    if (length > 0) {
+        gint64 len_seconds = length / 1000000;
+        gint64 rem_seconds = len_seconds - pos_seconds;
+        if (rem_seconds < 0) rem_seconds = 0;
+        int mins = rem_seconds / 60;
+        int secs = rem_seconds % 60;
+        snprintf(time_str, sizeof(time_str), "-%d:%02d", mins, secs);
+        fraction = (double)position / (double)length;
+    } else {
+        int mins = pos_seconds / 60;
+        int secs = pos_seconds % 60;
+        snprintf(time_str, sizeof(time_str), "%d:%02d", mins, secs);
+        fraction = 0.0;
+    }
+
+    if (fraction > 1.0) fraction = 1.0;
+    if (fraction < 0.0) fraction = 0.0;
+
+    // The text changes once per second; skip the relayout on the other frames
+    if (g_strcmp0(gtk_label_get_text(GTK_LABEL(state->time_remaining)), time_str) != 0) {
+        gtk_label_set_text(GTK_LABEL(state->time_remaining), time_str);
+    }
+    g_signal_handlers_block_by_func(state->progress_bar, on_change_value, state);
+    gtk_range_set_value(GTK_RANGE(state->progress_bar), fraction);
+    g_signal_handlers_unblock_by_func(state->progress_bar, on_change_value, state);
+}
+
+// Runs once per frame while playing and the progress bar is on screen
+static gboolean on_position_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer user_data) {
     AppState *state = (AppState *)user_data;
-    update_position(state);
+    if (!state->is_seeking) {
+        render_position(state, get_extrapolated_position(state));
+    }
     return G_SOURCE_CONTINUE;
 }
 
+// Animate only while the position actually moves
+static void update_position_ticking(AppState *state) {
+    gboolean moving = state->mpris_proxy && state->is_playing && state->playback_rate != 0.0;
+
+    if (moving && state->position_tick_id == 0) {
+        state->position_tick_id = gtk_widget_add_tick_callback(state->progress_bar,
+                                                               on_position_tick, state, NULL);
+    } else if (!moving && state->position_tick_id > 0) {
+        gtk_widget_remove_tick_callback(state->progress_bar, state->position_tick_id);
+        state->position_tick_id = 0;
+    }
+
+    if (!moving && !state->is_seeking) {
+        render_position(state, get_extrapolated_position(state));
+    }
+}
+
+// Follow Rate changes without a jump: rebase at the old rate first
+static void update_playback_rate(AppState *state) {
+    gdouble rate = 1.0;
+    GVariant *rate_var = g_dbus_proxy_get_cached_property(state->mpris_proxy, "Rate");
+    if (rate_var) {
+        if (g_variant_is_of_type(rate_var, G_VARIANT_TYPE_DOUBLE)) {
+            rate = g_variant_get_double(rate_var);
+        }
+        g_variant_unref(rate_var);
+    }
+
+    if (rate == state->playback_rate) return;
+
+    set_position_base(state, get_extrapolated_position(state));
+    state->playback_rate = rate;
+}
+
+// MPRIS Seeked: the player jumped, take its position as the new sync point
+static void on_player_signal(GDBusProxy *proxy, const gchar *sender_name,
+                             const gchar *signal_name, GVariant *parameters,
+                             gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+
+    if (g_strcmp0(signal_name, "Seeked") != 0) return;
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(x)"))) return;
+
+    gint64 position;
+    g_variant_get(parameters, "(x)", &position);
+    set_position_base(state, position);
+    if (!state->is_seeking) {
+        render_position(state, get_extrapolated_position(state));
+    }
+}
+
 static gboolean clear_seeking_flag(gpointer user_data) {
     AppState *state = (AppState *)user_data;
     state->is_seeking = FALSE;
@@ -822,74 +866,43 @@ static gboolean clear_seeking_flag(gpointer user_data) {
 }
 
 static void perform_seek(AppState *state, gdouble fraction) {
-    if (!state->mpris_proxy) return;
-    
-    GVariant *metadata = g_dbus_proxy_get_cached_property(state->mpris_proxy, "Metadata");
-    if (!metadata) return;
-    
-    gint64 length = 0;
-    const gchar *track_id = NULL;
-    GVariantIter iter;
-    gchar *key;
-    GVariant *val;
-
-    g_variant_iter_init(&iter, metadata);
-    while (g_variant_iter_loop(&iter, "{sv}", &key, &val)) {
-        if (g_strcmp0(key, "mpris:length") == 0) {
-            length = get_variant_as_int64(val);
-        } else if (g_strcmp0(key, "mpris:trackid") == 0) {
-            track_id = g_variant_get_string(val, NULL);
-        }
-    }
+    if (!state->mpris_proxy || !state->track) return;
+
+    gint64 length = state->track->length;
+    const gchar *track_id = state->track->track_id;
 
-    if (length > 0 && track_id) {
+    if (length > 0 && track_id && g_variant_is_object_path(track_id)) {
         gint64 target_position = (gint64)(fraction * length);
         g_dbus_proxy_call(state->mpris_proxy, "SetPosition",
             g_variant_new("(ox)", track_id, target_position),
             G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL, NULL);
+        // Assume the seek lands; the player's Seeked signal corrects it if not
+        set_position_base(state, target_position);
         g_print("Seeking to %.1f%% (position: %ld µs)\n", fraction * 100, target_position);
     }
-    g_variant_unref(metadata);
 }
 
 static void on_change_value(GtkRange *range, GtkScrollType scroll, gdouble value, gpointer user_data) {
     AppState *state = (AppState *)user_data;
     state->is_seeking = TRUE;
-    
-    if (state->mpris_proxy) {
-        GVariant *metadata = g_dbus_proxy_get_cached_property(state->mpris_proxy, "Metadata");
-        if (metadata) {
-            gint64 length = 0;
-            GVariantIter iter;
-            gchar *key;
-            GVariant *val;
-            
-            g_variant_iter_init(&iter, metadata);
-            while (g_variant_iter_loop(&iter, "{sv}", &key, &val)) {
-                if (g_strcmp0(key, "mpris:length") == 0) {
-                    length = get_variant_as_int64(val);
-                    break;
-                }
-            }
-            g_variant_unref(metadata);
-
-            if (length > 0) {
-                gint64 target_pos = (gint64)(value * length);
-                gint64 pos_seconds = target_pos / 1000000;
-                gint64 len_seconds = length / 1000000;
-                gint64 rem_seconds = len_seconds - pos_seconds;
-                
-                char time_str[32];
-                if (rem_seconds >= 0) {
-                    snprintf(time_str, sizeof(time_str), "-%ld:%02ld", 
-                            rem_seconds / 60, rem_seconds % 60);
-                } else {
-                    snprintf(time_str, sizeof(time_str), "%ld:%02ld", 
-                            pos_seconds / 60, pos_seconds % 60);
-                }
-                gtk_label_set_text(GTK_LABEL(state->time_remaining), time_str);
-            }
+
+    // Runs on every slider motion: read the parsed track, never the Metadata dict
+    gint64 length = track_length(state);
+    if (length > 0) {
+        gint64 target_pos = (gint64)(value * length);
+        gint64 pos_seconds = target_pos / 1000000;
+        gint64 len_seconds = length / 1000000;
+        gint64 rem_seconds = len_seconds - pos_seconds;
+        
+        char time_str[32];
+        if (rem_seconds >= 0) {
+            snprintf(time_str, sizeof(time_str), "-%ld:%02ld", 
+                    rem_seconds / 60, rem_seconds % 60);
+        } else {
+            snprintf(time_str, sizeof(time_str), "%ld:%02ld", 
+                    pos_seconds / 60, pos_seconds % 60);
         }
+        gtk_label_set_text(GTK_LABEL(state->time_remaining), time_str);
     }
 }
 
@@ -917,62 +930,26 @@ static void on_position_received(GObject *source_object, GAsyncResult *res, gpoi
         g_error_free(error);
         return;
     }
+
+    // Reply for a player we have since switched away from
+    if (G_DBUS_PROXY(source_object) != state->mpris_proxy) {
+        g_variant_unref(position_container);
+        return;
+    }
     
     GVariant *position_val_wrapped;
     g_variant_get(position_container, "(v)", &position_val_wrapped);
-    gint64 position = get_variant_as_int64(position_val_wrapped);
+    gint64 position = track_info_variant_to_int64(position_val_wrapped);
     g_variant_unref(position_val_wrapped);
     g_variant_unref(position_container);
-    
-    gint64 length = 0;
-    GVariant *metadata_var = g_dbus_proxy_get_cached_property(state->mpris_proxy, "Metadata");
-    
-    if (metadata_var) {
-        GVariantIter iter;
-        gchar *key;
-        GVariant *val;
-        g_variant_iter_init(&iter, metadata_var);
-        while (g_variant_iter_loop(&iter, "{sv}", &key, &val)) {
-            if (g_strcmp0(key, "mpris:length") == 0) {
-                length = get_variant_as_int64(val);
-                break;
-            }
-        }
-        g_variant_unref(metadata_var);
-    }
 
-    char time_str[32];
-    double fraction = 0.0;
-    gint64 pos_seconds = position / 1000000;
-
-    if (length > 0) {
-        gint64 len_seconds = length / 1000000;
-        gint64 rem_seconds = len_seconds - pos_seconds;
-        if (rem_seconds < 0) rem_seconds = 0;
-        int mins = rem_seconds / 60;
-        int secs = rem_seconds % 60;
-        snprintf(time_str, sizeof(time_str), "-%d:%02d", mins, secs);
-        fraction = (double)position / (double)length;
-    } else {
-        int mins = pos_seconds / 60;
-        int secs = pos_seconds % 60;
-        snprintf(time_str, sizeof(time_str), "%d:%02d", mins, secs);
-        fraction = 0.0;
-    }
-
-    if (fraction > 1.0) fraction = 1.0;
-    if (fraction < 0.0) fraction = 0.0;
-
-    gtk_label_set_text(GTK_LABEL(state->time_remaining), time_str);
-    g_signal_handlers_block_by_func(state->progress_bar, on_change_value, state);
-    gtk_range_set_value(GTK_RANGE(state->progress_bar), fraction);
-    g_signal_handlers_unblock_by_func(state->progress_bar, on_change_value, state);
-    
-            if (state->vertical_display) {
-        vertical_display_update_position(state->vertical_display, position, length);
+    set_position_base(state, position);
+    if (!state->is_seeking) {
+        render_position(state, position);
     }
 }
 
+// Re-read Position from the player (sync points only, never polled)
 static void update_position(AppState *state) {
     if (state->is_seeking) return;
     if (!state->mpris_proxy) return;
@@ -1017,56 +994,33 @@ static gboolean show_pending_notification(gpointer user_data) {
     return G_SOURCE_REMOVE;
 }
 
+// Forget what the widgets show so the next metadata update redraws everything
+static void reset_track_state(AppState *state) {
+    g_clear_pointer(&state->track, track_info_free);
+}
+
 static void update_metadata(AppState *state) {
     if (!state->mpris_proxy) return;
     GVariant *metadata = g_dbus_proxy_get_cached_property(state->mpris_proxy, "Metadata");
     if (!metadata) return;
 
-    GVariantIter iter;
-    GVariant *value;
-    gchar *key;
-    gchar *title = NULL;
-    gchar *artist = NULL;
-    gchar *art_url = NULL;
-    gchar *track_id = NULL;
-
-    g_variant_iter_init(&iter, metadata);
-    while (g_variant_iter_loop(&iter, "{sv}", &key, &value)) {
-        if (g_strcmp0(key, "xesam:title") == 0) {
-            g_free(title);
-            title = g_strdup(g_variant_get_string(value, NULL));
-        }
-        else if (g_strcmp0(key, "xesam:artist") == 0) {
-            if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING_ARRAY)) {
-                gsize length;
-                const gchar **artists = g_variant_get_strv(value, &length);
-                if (length > 0) {
-                    g_free(artist);
-                    artist = g_strdup(artists[0]);
-                }
-                g_free(artists);
-            }
-        }
-        else if (g_strcmp0(key, "mpris:artUrl") == 0) {
-            g_free(art_url);
-            art_url = g_strdup(g_variant_get_string(value, NULL));
-        }
-        else if (g_strcmp0(key, "mpris:trackid") == 0) {
-            g_free(track_id);
-            track_id = g_strdup(g_variant_get_string(value, NULL));
-        }
-    }
-    
-    gboolean track_changed = FALSE;
-    if (track_id && state->last_track_id) {
-        track_changed = (g_strcmp0(track_id, state->last_track_id) != 0);
-    } else if (track_id && !state->last_track_id) {
-        track_changed = TRUE;
-    }
-    
-    if (track_id) {
-        g_free(state->last_track_id);
-        state->last_track_id = g_strdup(track_id);
+    // Parse once per Metadata change; hot paths read state->track from here on
+    TrackInfo *previous = state->track;
+    TrackInfo *track = track_info_new(metadata);
+    g_variant_unref(metadata);
+    state->track = track;
+
+    const gchar *title = track->title;
+    const gchar *artist = track_info_get_artist(track);
+    const gchar *art_url = track->art_url;
+
+    gboolean track_changed = track->track_id &&
+        (!previous || g_strcmp0(track->track_id, previous->track_id) != 0);
+
+    // New track (or a player without track IDs reporting a new length): resync position
+    gboolean resync_position = track_changed || (previous && track->length != previous->length);
+    if (track_changed) {
+        set_position_base(state, 0);
     }
     
     if (state->layout->notifications_enabled && state->layout->now_playing_enabled && 
@@ -1089,52 +1043,39 @@ static void update_metadata(AppState *state) {
         state->notification_timer = g_timeout_add(300, show_pending_notification, state);
     }
     
-    if (title && strlen(title) > 0) {
-        gtk_label_set_text(GTK_LABEL(state->track_title), title);
-    } else {
-        gtk_label_set_text(GTK_LABEL(state->track_title), "No Track Playing");
+    // Only touch the widgets whose value actually changed (everything after a reset)
+    gboolean title_changed = !previous || g_strcmp0(title, previous->title) != 0;
+    gboolean artist_changed = !previous || g_strcmp0(artist, track_info_get_artist(previous)) != 0;
+    gboolean art_changed = !previous || g_strcmp0(art_url, previous->art_url) != 0;
+
+    if (title_changed) {
+        if (title && strlen(title) > 0) {
+            gtk_label_set_text(GTK_LABEL(state->track_title), title);
+        } else {
+            gtk_label_set_text(GTK_LABEL(state->track_title), "No Track Playing");
+        }
     }
     
-    if (artist && strlen(artist) > 0) {
-        gtk_label_set_text(GTK_LABEL(state->artist_label), artist);
-    } else {
-        gtk_label_set_text(GTK_LABEL(state->artist_label), "Unknown Artist");
+    if (artist_changed) {
+        if (artist && strlen(artist) > 0) {
+            gtk_label_set_text(GTK_LABEL(state->artist_label), artist);
+        } else {
+            gtk_label_set_text(GTK_LABEL(state->artist_label), "Unknown Artist");
+        }
     }
     
-    load_album_art_to_container(art_url, state->album_cover, 300);
-    
-    if (state->current_player) {
-        GError *error = NULL;
-        GDBusProxy *player_proxy = g_dbus_proxy_new_for_bus_sync(
-            G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
-            state->current_player, "/org/mpris/MediaPlayer2",
-            "org.mpris.MediaPlayer2", NULL, &error);
-
-        if (player_proxy && !error) {
-            GVariant *identity = g_dbus_proxy_get_cached_property(player_proxy, "Identity");
-            if (identity) {
-                gtk_label_set_text(GTK_LABEL(state->source_label), 
-                                   g_variant_get_string(identity, NULL));
-                g_variant_unref(identity);
-            }
-            g_object_unref(player_proxy);
-        } else if (error) {
-            g_error_free(error);
-        }
+    if (art_changed) {
+        load_album_art_to_container(art_url, state->album_cover, 300);
     }
     
-        if (state->vertical_display && title && artist) {
+    if (state->vertical_display && title && artist && (title_changed || artist_changed)) {
         vertical_display_update_track(state->vertical_display, title, artist);
     }
-    
 
-    g_free(title);
-    g_free(artist);
-    g_free(art_url);
-    g_free(track_id);
-    g_variant_unref(metadata);
-    update_position(state);
-    
+    track_info_free(previous);
+    if (resync_position) {
+        update_position(state);
+    }
 }
 
 static void update_playback_status(AppState *state) {
@@ -1143,11 +1084,19 @@ static void update_playback_status(AppState *state) {
     if (status_var) {
         const gchar *status = g_variant_get_string(status_var, NULL);
         gboolean was_playing = state->is_playing;
+        gint64 position = get_extrapolated_position(state);
         state->is_playing = g_strcmp0(status, "Playing") == 0;
+
+        // Freeze or restart the extrapolation where it currently is
+        if (state->is_playing != was_playing) {
+            set_position_base(state, position);
+        }
         
-        gchar *icon_path = get_icon_path(state->is_playing ? "pause.svg" : "play.svg");
-        gtk_image_set_from_file(GTK_IMAGE(state->play_icon), icon_path);
-        free_path(icon_path);
+        if (state->is_playing != was_playing) {
+            gchar *icon_path = get_icon_path(state->is_playing ? "pause.svg" : "play.svg");
+            gtk_image_set_from_file(GTK_IMAGE(state->play_icon), icon_path);
+            free_path(icon_path);
+        }
         
         // UPDATE VERTICAL DISPLAY
         if (state->vertical_display) {
@@ -1159,102 +1108,126 @@ static void update_playback_status(AppState *state) {
         
         g_variant_unref(status_var);
 
-        // When playback starts, retry visualizer target lookup
+        // Only capture while the player is actually playing
+        if (state->visualizer) {
+            visualizer_set_playing(state->visualizer, state->is_playing);
+        }
+
+        // When playback starts, retry the audio stream lookup
         // (audio stream may not exist until playback actually begins)
-        if (state->is_playing && !was_playing && state->visualizer) {
-            visualizer_retry_target(state->visualizer);
+        if (state->is_playing && !was_playing) {
+            resolve_player_audio(state);
+            update_position(state);  // Correct any drift while paused
         }
     }
+
+    update_playback_rate(state);
+    update_position_ticking(state);
+}
+
+// TRUE if a property is in this PropertiesChanged batch (changed or invalidated)
+static gboolean property_changed(GVariant *changed_properties, GStrv invalidated_properties,
+                                 const gchar *name) {
+    GVariant *value = g_variant_lookup_value(changed_properties, name, NULL);
+    if (value) {
+        g_variant_unref(value);
+        return TRUE;
+    }
+    return invalidated_properties && g_strv_contains((const gchar * const *)invalidated_properties, name);
 }
 
 static void on_properties_changed(GDBusProxy *proxy, GVariant *changed_properties,
                                   GStrv invalidated_properties, gpointer user_data) {
     AppState *state = (AppState *)user_data;
-    update_metadata(state);
-    update_playback_status(state);
+
+    // Dispatch on what changed; Volume (volume.c) and unrelated properties cost nothing here
+    if (property_changed(changed_properties, invalidated_properties, "Metadata")) {
+        update_metadata(state);
+    }
+    if (property_changed(changed_properties, invalidated_properties, "PlaybackStatus")) {
+        update_playback_status(state);
+    } else if (property_changed(changed_properties, invalidated_properties, "Rate")) {
+        update_playback_rate(state);
+        update_position_ticking(state);
+    }
+    if (property_changed(changed_properties, invalidated_properties, "CanSeek")) {
+        MprisPlayer *player = mpris_player_lookup(state->current_player);
+        if (player) state->can_seek = mpris_player_can_seek(player);
+    }
 }
 
-// Callback when player name appears/disappears on D-Bus
-static void on_player_name_changed(GDBusConnection *connection,
-                                    const gchar *sender_name,
-                                    const gchar *object_path,
-                                    const gchar *interface_name,
-                                    const gchar *signal_name,
-                                    GVariant *parameters,
-                                    gpointer user_data) {
+static gboolean reconnect_to_player(gpointer user_data) {
     AppState *state = (AppState *)user_data;
-    
-    const gchar *name;
-    const gchar *old_owner;
-    const gchar *new_owner;
-    g_variant_get(parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
-    
-    // Check if this is our current player
-    if (state->current_player && g_strcmp0(name, state->current_player) == 0) {
-        if (strlen(new_owner) == 0) {
-            // Our player disappeared!
-            g_print("⚠ Player disappeared: %s\n", state->current_player);
-            
-            if (state->mpris_proxy) {
-                g_object_unref(state->mpris_proxy);
-                state->mpris_proxy = NULL;
-            }
-            g_free(state->current_player);
-            state->current_player = NULL;
-            
-            // Clear UI
-            gtk_label_set_text(GTK_LABEL(state->track_title), "No Player");
-            gtk_label_set_text(GTK_LABEL(state->artist_label), "Waiting for music...");
-            gtk_label_set_text(GTK_LABEL(state->source_label), "");
-            clear_album_art_container(state->album_cover);
-            
-            // Try to reconnect after 2 seconds
-            if (state->reconnect_timer > 0) {
-                g_source_remove(state->reconnect_timer);
-            }
-            state->reconnect_timer = g_timeout_add_seconds(2, (GSourceFunc)find_active_player, state);
-        }
-    } else if (!state->current_player && g_str_has_prefix(name, "org.mpris.MediaPlayer2.")) {
-        // A new player appeared and we're not connected to anything
-        if (strlen(new_owner) > 0) {
-            g_print("✓ New player detected: %s\n", name);
-            find_active_player(state);
-        }
-    }
+    state->reconnect_timer = 0;
+    if (!state->current_player) find_active_player(state);
+    return G_SOURCE_REMOVE;
 }
 
-static void connect_to_player(AppState *state, const gchar *bus_name) {
-    if (state->mpris_proxy) g_object_unref(state->mpris_proxy);
-    g_free(state->current_player);
-    state->current_player = g_strdup(bus_name);
+// Registry: startup listing resolved
+static void on_players_ready(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    if (!state->current_player) find_active_player(state);
+    update_player_selector(state);
+}
 
-    GError *error = NULL;
-    state->mpris_proxy = g_dbus_proxy_new_for_bus_sync(
-        G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL, bus_name,
-        "/org/mpris/MediaPlayer2", "org.mpris.MediaPlayer2.Player", NULL, &error);
+// Registry: a player appeared
+static void on_player_added(const gchar *bus_name, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
 
-    if (error) {
-        g_printerr("Failed to connect: %s\n", error->message);
-        g_error_free(error);
-        return;
+    // Startup picks the preferred player once everything is listed
+    if (!player_registry_is_ready()) return;
+
+    // A new player appeared and we're not connected to anything
+    if (!state->current_player) {
+        find_active_player(state);
     }
+    update_player_selector(state);
+}
 
-    g_signal_connect(state->mpris_proxy, "g-properties-changed",
-                     G_CALLBACK(on_properties_changed), state);
-    update_metadata(state);
+// Registry: a player left the bus
+static void on_player_removed(const gchar *bus_name, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
 
-    if (state->volume) {
-        volume_update_player(state->volume, state->mpris_proxy, bus_name);
-    }
+    // Check if this is our current player
+    if (g_strcmp0(bus_name, state->current_player) == 0) {
+        // Our player disappeared!
+        g_print("⚠ Player disappeared: %s\n", state->current_player);
+
+        release_player_proxy(state);
+        if (state->player_cancellable) {
+            g_cancellable_cancel(state->player_cancellable);
+            g_clear_object(&state->player_cancellable);
+        }
+        g_free(state->current_player);
+        state->current_player = NULL;
+        reset_track_state(state);
+
+        // Clear UI
+        gtk_label_set_text(GTK_LABEL(state->track_title), "No Player");
+        gtk_label_set_text(GTK_LABEL(state->artist_label), "Waiting for music...");
+        gtk_label_set_text(GTK_LABEL(state->source_label), "");
+        clear_album_art_container(state->album_cover);
 
-    g_print("Connected to player: %s\n", bus_name);
+        // Give it 2 seconds to come back (restart) before picking another player
+        if (state->reconnect_timer > 0) {
+            g_source_remove(state->reconnect_timer);
+        }
+        state->reconnect_timer = g_timeout_add_seconds(2, reconnect_to_player, state);
+    }
+    update_player_selector(state);
 }
 
+static const PlayerRegistryEvents player_registry_events = {
+    .ready = on_players_ready,
+    .player_added = on_player_added,
+    .player_removed = on_player_removed,
+};
+
 static void find_active_player(AppState *state) {
     // Hi-Fi: Use multi-player logic with persistence
-    load_available_players(state);
+    guint count = player_registry_get_count();
 
-    if (state->player_count == 0) {
+    if (count == 0) {
         g_print("No MPRIS players found\n");
         return;
     }
@@ -1262,21 +1235,17 @@ static void find_active_player(AppState *state) {
     // First: Try to restore last-used player from persistent file
     gchar *persistent = load_preferred_player();
     if (persistent) {
-        for (int i = 0; state->players[i]; i++) {
-            if (g_strcmp0(state->players[i], persistent) == 0) {
-                g_print("✓ Restored last player: %s\n", persistent);
-                switch_to_player(state, persistent);
-                g_free(persistent);
-                return;
-            }
+        if (player_registry_index_of(persistent) >= 0) {
+            g_print("✓ Restored last player: %s\n", persistent);
+            switch_to_player(state, persistent);
+            g_free(persistent);
+            return;
         }
         g_free(persistent);
     }
 
     // Second: Connect to first available player
-    if (state->players[0]) {
-        switch_to_player(state, state->players[0]);
-    }
+    switch_to_player(state, player_registry_get(0));
 }
 
 static void on_play_clicked(GtkButton *button, gpointer user_data) {
@@ -1462,10 +1431,11 @@ static void activate(GtkApplication *app, gpointer user_data) {
     state->is_expanded = FALSE;
     state->is_visible = TRUE;
     state->is_seeking = FALSE;
+    state->playback_rate = 1.0;
     state->mpris_proxy = NULL;
     state->current_player = NULL;
-    state->last_track_id = NULL;
     state->layout = layout_load_config();
+    art_cache_set_budget_mb(state->layout->album_art_cache_mb);
     state->notification = notification_init(app);
     state->volume = NULL;
     state->visualizer = NULL;
@@ -1679,6 +1649,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
     if (state->layout->is_vertical && state->layout->vertical_display_enabled) {
         state->vertical_display = vertical_display_init();
         if (state->vertical_display) {
+            vertical_display_set_position_func(state->vertical_display,
+                                               get_vertical_display_position, state);
+
             // Create overlay: control bar as base, vertical display on top
             GtkWidget *overlay = gtk_overlay_new();
             gtk_overlay_set_child(GTK_OVERLAY(overlay), control_bar);
@@ -1704,9 +1677,16 @@ static void activate(GtkApplication *app, gpointer user_data) {
     // ========================================
     if (state->layout->visualizer_enabled && state->visualizer_box) {
         // Create visualizer (horizontal bars for vertical layout, vertical for horizontal)
-        state->visualizer = visualizer_init(!state->layout->is_vertical);
+        state->visualizer = visualizer_init(!state->layout->is_vertical,
+                                            state->layout->visualizer_fft_size);
 
         if (state->visualizer) {
+            visualizer_set_capture_source(state->visualizer,
+                                          state->layout->visualizer_capture_stream);
+            visualizer_set_capture_budget(state->visualizer,
+                                          state->layout->visualizer_capture_budget,
+                                          state->layout->visualizer_capture_rate);
+
             // Add visualizer container to the expanded section's visualizer_box
             gtk_box_append(GTK_BOX(state->visualizer_box), state->visualizer->container);
             gtk_widget_set_hexpand(state->visualizer->container, TRUE);
@@ -1811,26 +1791,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
     g_unix_signal_add(SIGUSR1, handle_sigusr1, NULL);
     g_unix_signal_add(SIGUSR2, handle_sigusr2, NULL);
 
-    // Setup D-Bus name watcher to monitor player appearance/disappearance
-    GDBusConnection *bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
-    if (bus) {
-        state->dbus_watch_id = g_dbus_connection_signal_subscribe(
-            bus,
-            "org.freedesktop.DBus",
-            "org.freedesktop.DBus",
-            "NameOwnerChanged",
-            "/org/freedesktop/DBus",
-            NULL,
-            G_DBUS_SIGNAL_FLAGS_NONE,
-            on_player_name_changed,
-            state,
-            NULL
-        );
-        g_print("✓ D-Bus name watcher enabled\n");
-    }
-
-    find_active_player(state);
-    state->update_timer = g_timeout_add_seconds(1, update_position_tick, state);
+    // Track MPRIS players; the first one is picked once the startup listing resolves
+    player_registry_start(&player_registry_events, state);
+
 
     g_print("Layout: %s edge (%s)\n",
             state->layout->edge == EDGE_RIGHT ? "right" :
@@ -1851,11 +1814,21 @@ static void activate(GtkApplication *app, gpointer user_data) {
     }
 }
 
+// The windows (and the widgets AppState points at) may already be gone here,
+// so only the PipeWire side is torn down: the visualizer's stream first,
+// then the shared connection it was created on
+static void on_shutdown(GApplication *app, gpointer user_data) {
+    if (global_state && global_state->visualizer) {
+        visualizer_stop(global_state->visualizer);
+    }
+    pw_service_shutdown();
+}
 
 int main(int argc, char **argv) {
     GtkApplication *app = gtk_application_new("com.hyprwave.app", G_APPLICATION_DEFAULT_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
     g_signal_connect(app, "startup", G_CALLBACK(load_css), NULL);
+    g_signal_connect(app, "shutdown", G_CALLBACK(on_shutdown), NULL);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
     return status;
@@ -0,0 +1,189 @@
+#include "mpris_player.h"
+
+#define MPRIS_OBJECT_PATH "/org/mpris/MediaPlayer2"
+
+static GHashTable *players = NULL;  // bus name -> MprisPlayer* (key owned by the player)
+
+static void mpris_player_free(MprisPlayer *player) {
+    if (player->root_proxy) {
+        g_signal_handlers_disconnect_by_data(player->root_proxy, player);
+        g_object_unref(player->root_proxy);
+    }
+    g_clear_object(&player->player_proxy);
+    g_clear_error(&player->error);
+    g_free(player->identity);
+    g_free(player->bus_name);
+    g_free(player);
+}
+
+static void complete_waiters(MprisPlayer *player, const GError *error) {
+    GSList *waiters = player->waiters;
+    player->waiters = NULL;
+
+    for (GSList *l = waiters; l; l = l->next) {
+        GTask *task = G_TASK(l->data);
+        if (error) {
+            g_task_return_error(task, g_error_copy(error));
+        } else {
+            g_task_return_boolean(task, TRUE);
+        }
+        g_object_unref(task);
+    }
+    g_slist_free(waiters);
+}
+
+static void update_identity(MprisPlayer *player) {
+    GVariant *identity = g_dbus_proxy_get_cached_property(player->root_proxy, "Identity");
+    if (!identity) return;
+
+    if (g_variant_is_of_type(identity, G_VARIANT_TYPE_STRING)) {
+        g_free(player->identity);
+        player->identity = g_variant_dup_string(identity, NULL);
+    }
+    g_variant_unref(identity);
+}
+
+static void on_root_properties_changed(GDBusProxy *proxy, GVariant *changed_properties,
+                                       GStrv invalidated_properties, gpointer user_data) {
+    update_identity((MprisPlayer *)user_data);
+}
+
+// Both proxy creations report here; the last one completes the waiters
+static void creation_step_done(MprisPlayer *player) {
+    if (--player->pending > 0) return;
+
+    // Forgotten while connecting: waiters already failed
+    if (player->removed) {
+        mpris_player_free(player);
+        return;
+    }
+
+    if (!player->player_proxy) {
+        g_hash_table_remove(players, player->bus_name);
+        complete_waiters(player, player->error);
+        mpris_player_free(player);
+        return;
+    }
+
+    player->ready = TRUE;
+    complete_waiters(player, NULL);
+}
+
+static void on_root_proxy_ready(GObject *source, GAsyncResult *result, gpointer user_data) {
+    MprisPlayer *player = (MprisPlayer *)user_data;
+    GDBusProxy *proxy = g_dbus_proxy_new_for_bus_finish(result, NULL);
+
+    // Identity is optional; a missing root interface still leaves a usable player
+    if (proxy && player->removed) {
+        g_object_unref(proxy);
+    } else if (proxy) {
+        player->root_proxy = proxy;
+        g_signal_connect(proxy, "g-properties-changed",
+                         G_CALLBACK(on_root_properties_changed), player);
+        update_identity(player);
+    }
+
+    creation_step_done(player);
+}
+
+static void on_player_proxy_ready(GObject *source, GAsyncResult *result, gpointer user_data) {
+    MprisPlayer *player = (MprisPlayer *)user_data;
+    GError *error = NULL;
+    GDBusProxy *proxy = g_dbus_proxy_new_for_bus_finish(result, &error);
+
+    if (proxy && player->removed) {
+        g_object_unref(proxy);
+    } else if (proxy) {
+        player->player_proxy = proxy;
+    } else {
+        player->error = error;
+    }
+
+    creation_step_done(player);
+}
+
+void mpris_player_get_async(const gchar *bus_name, GCancellable *cancellable,
+                            GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_source_tag(task, mpris_player_get_async);
+    g_task_set_task_data(task, g_strdup(bus_name), g_free);
+
+    if (!players) {
+        players = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+
+    MprisPlayer *player = g_hash_table_lookup(players, bus_name);
+    if (player && player->ready) {
+        g_task_return_boolean(task, TRUE);
+        g_object_unref(task);
+        return;
+    }
+
+    if (!player) {
+        player = g_new0(MprisPlayer, 1);
+        player->bus_name = g_strdup(bus_name);
+        player->pending = 2;
+        g_hash_table_insert(players, player->bus_name, player);
+
+        // Not tied to the caller's cancellable: other callers may share the result
+        g_dbus_proxy_new_for_bus(G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
+                                 bus_name, MPRIS_OBJECT_PATH, "org.mpris.MediaPlayer2",
+                                 NULL, on_root_proxy_ready, player);
+        g_dbus_proxy_new_for_bus(G_BUS_TYPE_SESSION, G_DBUS_PROXY_FLAGS_NONE, NULL,
+                                 bus_name, MPRIS_OBJECT_PATH, "org.mpris.MediaPlayer2.Player",
+                                 NULL, on_player_proxy_ready, player);
+    }
+
+    player->waiters = g_slist_prepend(player->waiters, task);
+}
+
+MprisPlayer* mpris_player_get_finish(GAsyncResult *result, GError **error) {
+    GTask *task = G_TASK(result);
+    if (!g_task_propagate_boolean(task, error)) return NULL;
+
+    // The player may have been forgotten between completion and this callback
+    const gchar *bus_name = g_task_get_task_data(task);
+    MprisPlayer *player = mpris_player_lookup(bus_name);
+    if (!player) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_CLOSED, "Player %s went away", bus_name);
+    }
+    return player;
+}
+
+MprisPlayer* mpris_player_lookup(const gchar *bus_name) {
+    if (!players || !bus_name) return NULL;
+
+    MprisPlayer *player = g_hash_table_lookup(players, bus_name);
+    return player && player->ready ? player : NULL;
+}
+
+gboolean mpris_player_can_seek(MprisPlayer *player) {
+    GVariant *value = g_dbus_proxy_get_cached_property(player->player_proxy, "CanSeek");
+    if (!value) return FALSE;
+
+    gboolean can_seek = g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN) &&
+                        g_variant_get_boolean(value);
+    g_variant_unref(value);
+    return can_seek;
+}
+
+void mpris_player_forget(const gchar *bus_name) {
+    if (!players || !bus_name) return;
+
+    MprisPlayer *player = g_hash_table_lookup(players, bus_name);
+    if (!player) return;
+
+    g_hash_table_remove(players, player->bus_name);
+
+    if (player->pending > 0) {
+        // Proxy creation still running: fail the waiters now, free when it finishes
+        GError *error = g_error_new(G_IO_ERROR, G_IO_ERROR_CLOSED,
+                                    "Player %s went away", player->bus_name);
+        player->removed = TRUE;
+        complete_waiters(player, error);
+        g_error_free(error);
+        return;
+    }
+
+    mpris_player_free(player);
+}
@@ -0,0 +1,69 @@
+#ifndef MPRIS_PLAYER_H
+#define MPRIS_PLAYER_H
+
+#include <gio/gio.h>
+
+/**
+ * MPRIS Player Cache
+ *
+ * One entry per player bus name holding its org.mpris.MediaPlayer2 (root)
+ * and org.mpris.MediaPlayer2.Player proxies. Both are created
+ * asynchronously the first time a player is needed and then reused, so
+ * switching back to a player, reading its Identity or checking CanSeek
+ * costs no D-Bus round-trip. The proxies' property caches are kept up to
+ * date by PropertiesChanged.
+ *
+ * Entries live until mpris_player_forget() is called for the bus name
+ * (when its owner leaves the bus). Use from the main thread only.
+ */
+
+typedef struct {
+    gchar *bus_name;
+    GDBusProxy *root_proxy;     // org.mpris.MediaPlayer2, NULL if it failed
+    GDBusProxy *player_proxy;   // org.mpris.MediaPlayer2.Player
+    gchar *identity;            // Cached Identity, NULL if the player has none
+    gboolean ready;             // Proxies created
+
+    // Internal: creation in progress
+    guint pending;
+    gboolean removed;
+    GError *error;
+    GSList *waiters;            // GTasks waiting for the proxies
+} MprisPlayer;
+
+/**
+ * Get the cached player for a bus name, creating its proxies if needed.
+ * Completes on the next main loop iteration if the player is already cached.
+ *
+ * @param bus_name MPRIS bus name (org.mpris.MediaPlayer2.*)
+ * @param cancellable Cancels waiting (creation continues for other callers)
+ */
+void mpris_player_get_async(const gchar *bus_name, GCancellable *cancellable,
+                            GAsyncReadyCallback callback, gpointer user_data);
+
+/**
+ * Finish mpris_player_get_async().
+ *
+ * @return The cached player (owned by the cache, valid until forgotten), or NULL with error set
+ */
+MprisPlayer* mpris_player_get_finish(GAsyncResult *result, GError **error);
+
+/**
+ * Look up a player without creating it or touching D-Bus.
+ *
+ * @return The player if its proxies are ready, otherwise NULL
+ */
+MprisPlayer* mpris_player_lookup(const gchar *bus_name);
+
+/**
+ * CanSeek from the Player proxy's property cache.
+ */
+gboolean mpris_player_can_seek(MprisPlayer *player);
+
+/**
+ * Drop a player from the cache (its bus name vanished). Pending callers
+ * fail with G_IO_ERROR_CLOSED. Proxies referenced elsewhere stay alive.
+ */
+void mpris_player_forget(const gchar *bus_name);
+
+#endif // MPRIS_PLAYER_H
@@ -177,10 +177,10 @@ void notification_show(NotificationState *state,
     gtk_label_set_text(GTK_LABEL(state->artist_label), artist_text);
     g_free(artist_text);
 
-    // Only load album art if container is empty (art may be pre-loaded)
+    // Only load album art if container is empty (art may be pre-loaded or still loading)
     // This handles ephemeral temp files from Chromium that get deleted quickly
     GtkWidget *existing_art = gtk_widget_get_first_child(state->album_cover);
-    if (!existing_art) {
+    if (!existing_art && !album_art_is_loading(state->album_cover)) {
         load_album_art_to_container(art_url, state->album_cover, 70);
     }
 
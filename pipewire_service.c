@@ -0,0 +1,622 @@
+#include "pipewire_service.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <spa/param/props.h>
+#include <spa/pod/iter.h>
+
+/**
+ * Shared PipeWire Service Implementation
+ *
+ * Registry globals are turned into model entries as they arrive. Playback
+ * streams are bound once so their driver changes (info events) and
+ * volumes (subscribed SPA_PARAM_Props) stay current without any consumer
+ * talking to the server itself.
+ */
+
+#define SERVICE_SYNC_TIMEOUT_SEC 2
+#define RECONNECT_MIN_DELAY_MS 1000   // First retry after the server went away
+#define RECONNECT_MAX_DELAY_MS 30000  // Backoff cap while it stays down
+
+typedef struct {
+    guint id;
+    const PwServiceEvents *events;
+    gpointer user_data;
+} ServiceListener;
+
+static struct {
+    struct pw_thread_loop *loop;
+    struct pw_context *context;
+    struct pw_core *core;
+    struct pw_registry *registry;
+    struct spa_hook core_listener;
+    struct spa_hook registry_listener;
+    GHashTable *nodes;             // node id -> PwServiceNode*
+    GHashTable *streams_by_serial; // object.serial -> PwServiceNode* (streams only)
+    GHashTable *ports;             // port id -> PwServicePort*
+    GHashTable *links;             // link id -> PwServiceLink*
+    GPtrArray *listeners;          // ServiceListener*
+    guint next_listener_id;
+    gint pending_seq;
+    gboolean synced;
+    gboolean connected;
+    gboolean init_attempted;
+    struct spa_source *reconnect_timer; // On the service loop
+    gboolean reconnect_armed;
+    guint reconnect_delay_ms;
+    gint reconnect_seq;            // Sync sent by an asynchronous reconnect
+    guint reconnect_syncs;         // Roundtrips it still waits for
+} service;
+
+// Serializes the lazy connect: lookups may come from worker threads
+static GMutex service_init_lock;
+
+static void service_node_free(gpointer data) {
+    PwServiceNode *node = (PwServiceNode *)data;
+    if (!node) return;
+    if (node->proxy) {
+        spa_hook_remove(&node->node_listener);
+        pw_proxy_destroy((struct pw_proxy *)node->proxy);
+    }
+    g_free(node->name);
+    g_free(node->app_name);
+    g_free(node);
+}
+
+static void service_port_free(gpointer data) {
+    PwServicePort *port = (PwServicePort *)data;
+    if (!port) return;
+    g_free(port->channel);
+    g_free(port);
+}
+
+// ========================================
+// LISTENER DISPATCH
+// ========================================
+
+static void notify_node_added(const PwServiceNode *node) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->node_added) l->events->node_added(node, l->user_data);
+    }
+}
+
+static void notify_node_changed(const PwServiceNode *node, guint changes) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->node_changed) l->events->node_changed(node, changes, l->user_data);
+    }
+}
+
+static void notify_node_removed(const PwServiceNode *node) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->node_removed) l->events->node_removed(node, l->user_data);
+    }
+}
+
+static void notify_port_added(const PwServicePort *port) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->port_added) l->events->port_added(port, l->user_data);
+    }
+}
+
+static void notify_port_removed(const PwServicePort *port) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->port_removed) l->events->port_removed(port, l->user_data);
+    }
+}
+
+static void notify_connection_lost(void) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->connection_lost) l->events->connection_lost(l->user_data);
+    }
+}
+
+static void notify_reconnected(void) {
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->events->reconnected) l->events->reconnected(l->user_data);
+    }
+}
+
+// ========================================
+// BOUND STREAM EVENTS
+// ========================================
+
+// Info events keep driver_id current when a stream moves between sinks
+static void on_node_info(void *data, const struct pw_node_info *info) {
+    PwServiceNode *node = (PwServiceNode *)data;
+
+    if (!(info->change_mask & PW_NODE_CHANGE_MASK_PROPS) || !info->props) return;
+
+    const char *driver_str = spa_dict_lookup(info->props, PW_KEY_NODE_DRIVER_ID);
+    guint32 driver_id = driver_str ? (guint32)atoi(driver_str) : 0;
+    if (driver_id == 0 || driver_id == node->driver_id) return;
+
+    node->driver_id = driver_id;
+    notify_node_changed(node, PW_SERVICE_CHANGE_DRIVER);
+}
+
+// Props param updates keep the cached channel volumes current
+static void on_node_param(void *data, int seq, uint32_t id, uint32_t index,
+                          uint32_t next, const struct spa_pod *param) {
+    PwServiceNode *node = (PwServiceNode *)data;
+
+    if (id != SPA_PARAM_Props || param == NULL || !spa_pod_is_object(param)) {
+        return;
+    }
+
+    const struct spa_pod_object *obj = (const struct spa_pod_object *)param;
+    const struct spa_pod_prop *prop;
+    SPA_POD_OBJECT_FOREACH(obj, prop) {
+        if (prop->key != SPA_PROP_channelVolumes) continue;
+
+        uint32_t n = spa_pod_copy_array(&prop->value, SPA_TYPE_Float,
+                                        node->channel_volumes, SPA_AUDIO_MAX_CHANNELS);
+        if (n > 0) {
+            node->n_channels = n;
+            node->has_volume = TRUE;
+            notify_node_changed(node, PW_SERVICE_CHANGE_VOLUME);
+        }
+    }
+}
+
+static const struct pw_node_events node_events = {
+    PW_VERSION_NODE_EVENTS,
+    .info = on_node_info,
+    .param = on_node_param,
+};
+
+// ========================================
+// REGISTRY
+// ========================================
+
+static void on_registry_link(uint32_t id, const struct spa_dict *props) {
+    const char *out_str = spa_dict_lookup(props, PW_KEY_LINK_OUTPUT_NODE);
+    const char *in_str = spa_dict_lookup(props, PW_KEY_LINK_INPUT_NODE);
+    if (!out_str || !in_str) return;
+
+    PwServiceLink *link = g_new0(PwServiceLink, 1);
+    link->id = id;
+    link->output_node = (guint32)atoi(out_str);
+    link->input_node = (guint32)atoi(in_str);
+    g_hash_table_insert(service.links, GUINT_TO_POINTER(id), link);
+}
+
+static void on_registry_port(uint32_t id, const struct spa_dict *props) {
+    const char *node_str = spa_dict_lookup(props, PW_KEY_NODE_ID);
+    const char *direction = spa_dict_lookup(props, PW_KEY_PORT_DIRECTION);
+    const char *monitor = spa_dict_lookup(props, PW_KEY_PORT_MONITOR);
+    if (!node_str || !direction) return;
+
+    PwServicePort *port = g_new0(PwServicePort, 1);
+    port->id = id;
+    port->node_id = (guint32)atoi(node_str);
+    port->is_output = strcmp(direction, "out") == 0;
+    port->is_monitor = monitor && strcmp(monitor, "true") == 0;
+    port->channel = g_strdup(spa_dict_lookup(props, PW_KEY_AUDIO_CHANNEL));
+    g_hash_table_insert(service.ports, GUINT_TO_POINTER(id), port);
+
+    notify_port_added(port);
+}
+
+static void on_registry_node(uint32_t id, const char *type, const struct spa_dict *props) {
+    const char *media_class = spa_dict_lookup(props, PW_KEY_MEDIA_CLASS);
+    if (!media_class) return;
+
+    PwServiceNodeKind kind;
+    const char *serial_str = spa_dict_lookup(props, PW_KEY_OBJECT_SERIAL);
+
+    if (strcmp(media_class, "Audio/Sink") == 0) {
+        kind = PW_SERVICE_NODE_SINK;
+    } else if (strstr(media_class, "Stream/Output/Audio") != NULL && serial_str) {
+        kind = PW_SERVICE_NODE_STREAM;
+    } else {
+        return;  // Not an audio node we model
+    }
+
+    const char *pid_str = spa_dict_lookup(props, PW_KEY_APP_PROCESS_ID);
+    const char *driver_str = spa_dict_lookup(props, PW_KEY_NODE_DRIVER_ID);
+
+    PwServiceNode *node = g_new0(PwServiceNode, 1);
+    node->id = id;
+    node->kind = kind;
+    node->serial = serial_str ? atoi(serial_str) : -1;
+    node->pid = pid_str ? (guint32)atoi(pid_str) : 0;
+    node->driver_id = driver_str ? (guint32)atoi(driver_str) : 0;
+    node->name = g_strdup(spa_dict_lookup(props, PW_KEY_NODE_NAME));
+    node->app_name = g_strdup(spa_dict_lookup(props, PW_KEY_APP_NAME));
+
+    // Bind streams once for everyone: info events for sink moves, Props for volume
+    if (kind == PW_SERVICE_NODE_STREAM) {
+        node->proxy = pw_registry_bind(service.registry, id, type, PW_VERSION_NODE, 0);
+        if (node->proxy) {
+            uint32_t param_ids[] = { SPA_PARAM_Props };
+            pw_node_add_listener(node->proxy, &node->node_listener, &node_events, node);
+            pw_node_subscribe_params(node->proxy, param_ids, SPA_N_ELEMENTS(param_ids));
+        }
+        g_hash_table_replace(service.streams_by_serial, GINT_TO_POINTER(node->serial), node);
+    }
+
+    g_hash_table_insert(service.nodes, GUINT_TO_POINTER(id), node);
+    notify_node_added(node);
+}
+
+static void on_registry_global(void *data, uint32_t id, uint32_t permissions,
+                               const char *type, uint32_t version,
+                               const struct spa_dict *props) {
+    if (!props) return;
+
+    if (strcmp(type, PW_TYPE_INTERFACE_Node) == 0) {
+        on_registry_node(id, type, props);
+    } else if (strcmp(type, PW_TYPE_INTERFACE_Port) == 0) {
+        on_registry_port(id, props);
+    } else if (strcmp(type, PW_TYPE_INTERFACE_Link) == 0) {
+        on_registry_link(id, props);
+    }
+}
+
+static void on_registry_global_remove(void *data, uint32_t id) {
+    PwServiceNode *node = g_hash_table_lookup(service.nodes, GUINT_TO_POINTER(id));
+    if (node) {
+        notify_node_removed(node);
+        if (node->kind == PW_SERVICE_NODE_STREAM &&
+            g_hash_table_lookup(service.streams_by_serial, GINT_TO_POINTER(node->serial)) == node) {
+            g_hash_table_remove(service.streams_by_serial, GINT_TO_POINTER(node->serial));
+        }
+        g_hash_table_remove(service.nodes, GUINT_TO_POINTER(id));
+        return;
+    }
+
+    PwServicePort *port = g_hash_table_lookup(service.ports, GUINT_TO_POINTER(id));
+    if (port) {
+        notify_port_removed(port);
+        g_hash_table_remove(service.ports, GUINT_TO_POINTER(id));
+        return;
+    }
+
+    g_hash_table_remove(service.links, GUINT_TO_POINTER(id));
+}
+
+static const struct pw_registry_events registry_events = {
+    PW_VERSION_REGISTRY_EVENTS,
+    .global = on_registry_global,
+    .global_remove = on_registry_global_remove,
+};
+
+// ========================================
+// CORE
+// ========================================
+
+static void on_core_done(void *data, uint32_t id, int seq) {
+    if (id != PW_ID_CORE) return;
+
+    if (seq == service.pending_seq) {
+        service.synced = TRUE;
+        pw_thread_loop_signal(service.loop, false);
+    }
+
+    // Reconnect in progress: the same two roundtrips as the first connect,
+    // chained here instead of waited for
+    if (service.reconnect_syncs > 0 && seq == service.reconnect_seq) {
+        if (--service.reconnect_syncs > 0) {
+            service.reconnect_seq = pw_core_sync(service.core, PW_ID_CORE, 0);
+        } else {
+            service.reconnect_delay_ms = 0;
+            g_print("✓ PipeWire service reconnected (%u audio nodes)\n",
+                    g_hash_table_size(service.nodes));
+        }
+    }
+}
+
+// Service thread (loop locked): arm the reconnect timer, backing off while
+// the server stays unreachable
+static void schedule_reconnect(void) {
+    if (service.reconnect_armed || !service.reconnect_timer) return;
+
+    service.reconnect_delay_ms = service.reconnect_delay_ms > 0 ?
+        MIN(service.reconnect_delay_ms * 2, RECONNECT_MAX_DELAY_MS) : RECONNECT_MIN_DELAY_MS;
+
+    struct timespec timeout = {
+        .tv_sec = service.reconnect_delay_ms / 1000,
+        .tv_nsec = (service.reconnect_delay_ms % 1000) * SPA_NSEC_PER_MSEC,
+    };
+    pw_loop_update_timer(pw_thread_loop_get_loop(service.loop), service.reconnect_timer,
+                         &timeout, NULL, false);
+    service.reconnect_armed = TRUE;
+}
+
+static void on_core_error(void *data, uint32_t id, int seq, int res, const char *message) {
+    if (id != PW_ID_CORE) return;
+
+    g_printerr("PipeWire: Connection error: %s\n", message ? message : "unknown");
+    if (res == -EPIPE && service.connected) {
+        // Server gone (e.g. restarted): rebuild the core from a timer, not from
+        // inside this core's own event emission
+        service.connected = FALSE;
+        service.reconnect_syncs = 0;
+        schedule_reconnect();
+    }
+    service.synced = TRUE;
+    pw_thread_loop_signal(service.loop, false);
+}
+
+static const struct pw_core_events core_events = {
+    PW_VERSION_CORE_EVENTS,
+    .done = on_core_done,
+    .error = on_core_error,
+};
+
+// Wait until the server has processed everything sent so far.
+// Must be called with the thread loop locked.
+static gboolean service_roundtrip(void) {
+    service.synced = FALSE;
+    service.pending_seq = pw_core_sync(service.core, PW_ID_CORE, service.pending_seq);
+
+    while (!service.synced) {
+        if (pw_thread_loop_timed_wait(service.loop, SERVICE_SYNC_TIMEOUT_SEC) != 0) {
+            g_printerr("PipeWire: Timed out waiting for server\n");
+            return FALSE;
+        }
+    }
+    return service.connected;
+}
+
+// Drop the graph model and the core it came from. Listeners stay subscribed.
+// Must be called with the thread loop locked.
+static void service_disconnect_core(void) {
+    // Bound stream proxies must go before the core does
+    g_hash_table_remove_all(service.streams_by_serial);
+    g_hash_table_remove_all(service.nodes);
+    g_hash_table_remove_all(service.ports);
+    g_hash_table_remove_all(service.links);
+
+    if (service.registry) {
+        spa_hook_remove(&service.registry_listener);
+        pw_proxy_destroy((struct pw_proxy *)service.registry);
+        service.registry = NULL;
+    }
+    if (service.core) {
+        spa_hook_remove(&service.core_listener);
+        pw_core_disconnect(service.core);
+        service.core = NULL;
+    }
+    service.connected = FALSE;
+}
+
+// Connect the core and request the registry; registry globals reach
+// listeners through node_added/port_added as they arrive.
+// Must be called with the thread loop locked.
+static gboolean service_connect_core(void) {
+    service.core = pw_context_connect(service.context, NULL, 0);
+    if (!service.core) {
+        g_printerr("PipeWire: Failed to connect\n");
+        return FALSE;
+    }
+    service.connected = TRUE;
+
+    spa_zero(service.core_listener);
+    pw_core_add_listener(service.core, &service.core_listener, &core_events, NULL);
+
+    // Consumers recreate their streams on the new core before the graph replays
+    notify_reconnected();
+
+    service.registry = pw_core_get_registry(service.core, PW_VERSION_REGISTRY, 0);
+    spa_zero(service.registry_listener);
+    pw_registry_add_listener(service.registry, &service.registry_listener,
+                             &registry_events, NULL);
+    return TRUE;
+}
+
+// Service thread (loop locked): the server went away. Tear down the dead core
+// and connect a new one without waiting for the server; on_core_done finishes
+// the enumeration.
+static void on_reconnect_timer(void *data, uint64_t expirations) {
+    (void)data;
+    (void)expirations;
+
+    service.reconnect_armed = FALSE;
+
+    // Consumers drop their streams and model pointers before the core goes
+    notify_connection_lost();
+    service_disconnect_core();
+
+    if (!service_connect_core()) {
+        // A failed attempt may leave a half-built core; next try starts clean
+        g_printerr("PipeWire: Reconnect failed, retrying\n");
+        service.connected = FALSE;
+        schedule_reconnect();
+        return;
+    }
+
+    // First roundtrip enumerates globals, second flushes the Props subscriptions
+    service.reconnect_syncs = 2;
+    service.reconnect_seq = pw_core_sync(service.core, PW_ID_CORE, 0);
+}
+
+// Connect once. Must be called with service_init_lock held.
+static gboolean service_connect(void) {
+    service.init_attempted = TRUE;
+
+    pw_init(NULL, NULL);
+
+    service.loop = pw_thread_loop_new("hyprwave-pipewire", NULL);
+    if (!service.loop) {
+        g_printerr("PipeWire: Failed to create thread loop\n");
+        return FALSE;
+    }
+
+    service.context = pw_context_new(pw_thread_loop_get_loop(service.loop), NULL, 0);
+    if (!service.context) {
+        g_printerr("PipeWire: Failed to create context\n");
+        return FALSE;
+    }
+
+    service.nodes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, service_node_free);
+    service.streams_by_serial = g_hash_table_new(g_direct_hash, g_direct_equal);
+    service.ports = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, service_port_free);
+    service.links = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    service.listeners = g_ptr_array_new_with_free_func(g_free);
+
+    // Added before the thread runs, so no lock is needed yet
+    service.reconnect_timer = pw_loop_add_timer(pw_thread_loop_get_loop(service.loop),
+                                                on_reconnect_timer, NULL);
+
+    if (pw_thread_loop_start(service.loop) < 0) {
+        g_printerr("PipeWire: Failed to start thread loop\n");
+        return FALSE;
+    }
+
+    // First roundtrip enumerates globals, second flushes the Props subscriptions
+    pw_thread_loop_lock(service.loop);
+    gboolean ok = service_connect_core() && service_roundtrip() && service_roundtrip();
+    guint n_nodes = g_hash_table_size(service.nodes);
+    pw_thread_loop_unlock(service.loop);
+
+    if (ok) {
+        g_print("✓ PipeWire service connected (%u audio nodes)\n", n_nodes);
+    }
+    return ok;
+}
+
+gboolean pw_service_ensure_connected(void) {
+    g_mutex_lock(&service_init_lock);
+    gboolean ok = service.connected || (!service.init_attempted && service_connect());
+    g_mutex_unlock(&service_init_lock);
+    return ok;
+}
+
+void pw_service_shutdown(void) {
+    g_mutex_lock(&service_init_lock);
+
+    // Stop the thread first: the reconnect timer fires there, so nothing can
+    // arm or run it once the loop is stopped
+    if (service.loop) {
+        pw_thread_loop_stop(service.loop);
+    }
+    if (service.reconnect_timer) {
+        pw_loop_destroy_source(pw_thread_loop_get_loop(service.loop), service.reconnect_timer);
+        service.reconnect_timer = NULL;
+        service.reconnect_armed = FALSE;
+    }
+    if (service.nodes) {
+        service_disconnect_core();
+        g_hash_table_destroy(service.streams_by_serial);
+        g_hash_table_destroy(service.nodes);
+        g_hash_table_destroy(service.ports);
+        g_hash_table_destroy(service.links);
+        g_ptr_array_free(service.listeners, TRUE);
+        service.streams_by_serial = NULL;
+        service.nodes = NULL;
+        service.ports = NULL;
+        service.links = NULL;
+        service.listeners = NULL;
+    }
+    if (service.context) {
+        pw_context_destroy(service.context);
+        service.context = NULL;
+    }
+    if (service.loop) {
+        pw_thread_loop_destroy(service.loop);
+        service.loop = NULL;
+        pw_deinit();
+    }
+    service.connected = FALSE;
+
+    g_mutex_unlock(&service_init_lock);
+}
+
+void pw_service_lock(void) {
+    if (service.loop) pw_thread_loop_lock(service.loop);
+}
+
+void pw_service_unlock(void) {
+    if (service.loop) pw_thread_loop_unlock(service.loop);
+}
+
+struct pw_core* pw_service_get_core(void) {
+    return service.core;
+}
+
+struct pw_context* pw_service_get_context(void) {
+    return service.context;
+}
+
+struct pw_loop* pw_service_get_loop(void) {
+    return service.loop ? pw_thread_loop_get_loop(service.loop) : NULL;
+}
+
+guint pw_service_add_listener(const PwServiceEvents *events, gpointer user_data) {
+    if (!events || !service.connected) return 0;
+
+    pw_thread_loop_lock(service.loop);
+
+    ServiceListener *l = g_new0(ServiceListener, 1);
+    l->id = ++service.next_listener_id;
+    l->events = events;
+    l->user_data = user_data;
+    g_ptr_array_add(service.listeners, l);
+
+    // Replay the current graph so late subscribers see the same model as early ones
+    GHashTableIter iter;
+    gpointer value;
+    if (events->node_added) {
+        g_hash_table_iter_init(&iter, service.nodes);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            events->node_added((PwServiceNode *)value, user_data);
+        }
+    }
+    if (events->port_added) {
+        g_hash_table_iter_init(&iter, service.ports);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            events->port_added((PwServicePort *)value, user_data);
+        }
+    }
+
+    pw_thread_loop_unlock(service.loop);
+    return l->id;
+}
+
+void pw_service_remove_listener(guint listener_id) {
+    if (listener_id == 0 || !service.listeners) return;
+
+    pw_thread_loop_lock(service.loop);
+    for (guint i = 0; i < service.listeners->len; i++) {
+        ServiceListener *l = g_ptr_array_index(service.listeners, i);
+        if (l->id == listener_id) {
+            g_ptr_array_remove_index(service.listeners, i);
+            break;
+        }
+    }
+    pw_thread_loop_unlock(service.loop);
+}
+
+GHashTable* pw_service_get_nodes(void) {
+    return service.nodes;
+}
+
+GHashTable* pw_service_get_ports(void) {
+    return service.ports;
+}
+
+GHashTable* pw_service_get_links(void) {
+    return service.links;
+}
+
+PwServiceNode* pw_service_get_node(guint32 id) {
+    return service.nodes ? g_hash_table_lookup(service.nodes, GUINT_TO_POINTER(id)) : NULL;
+}
+
+PwServiceNode* pw_service_find_stream_by_serial(gint serial) {
+    return service.streams_by_serial ?
+        g_hash_table_lookup(service.streams_by_serial, GINT_TO_POINTER(serial)) : NULL;
+}
+
+gboolean pw_service_is_sink(guint32 id) {
+    PwServiceNode *node = pw_service_get_node(id);
+    return node && node->kind == PW_SERVICE_NODE_SINK;
+}
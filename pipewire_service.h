@@ -0,0 +1,136 @@
+#ifndef PIPEWIRE_SERVICE_H
+#define PIPEWIRE_SERVICE_H
+
+#include <glib.h>
+#include <pipewire/pipewire.h>
+#include <spa/param/audio/raw.h>
+
+/**
+ * Shared PipeWire Service
+ *
+ * One process-wide PipeWire connection: a single thread loop, context,
+ * core and registry, plus a live model of the audio graph (sinks,
+ * playback streams with their volumes, ports and links). Volume control
+ * and the visualizer read the model and subscribe to its changes instead
+ * of each opening a socket and enumerating the registry again.
+ *
+ * If the server goes away (EPIPE, e.g. a PipeWire restart) the service
+ * reconnects from its own loop thread with backoff, never blocking the
+ * main loop. Listeners stay subscribed
+ * and see connection_lost, then reconnected, then the new graph replayed.
+ *
+ * Threading: the model changes only on the service's loop thread, and
+ * listener callbacks run there with the loop locked. Any other thread
+ * must hold pw_service_lock() while reading the model or calling pw_*
+ * functions on the shared core.
+ */
+
+typedef enum {
+    PW_SERVICE_NODE_SINK,    // Audio/Sink
+    PW_SERVICE_NODE_STREAM,  // Stream/Output/Audio (an application's playback stream)
+} PwServiceNodeKind;
+
+// Change flags passed to node_changed
+#define PW_SERVICE_CHANGE_DRIVER (1 << 0)  // Stream moved to another sink
+#define PW_SERVICE_CHANGE_VOLUME (1 << 1)  // channelVolumes changed
+
+typedef struct {
+    guint32 id;
+    PwServiceNodeKind kind;
+    gint serial;             // object.serial (same as the pactl sink-input index)
+    guint32 pid;             // application.process.id (0 if unknown)
+    guint32 driver_id;       // Node scheduling this stream (its sink), 0 if unknown
+    gchar *name;             // node.name
+    gchar *app_name;         // application.name
+    guint32 n_channels;
+    float channel_volumes[SPA_AUDIO_MAX_CHANNELS];  // Linear gain per channel
+    gboolean has_volume;
+    struct pw_node *proxy;   // Bound proxy (streams only)
+    struct spa_hook node_listener;
+} PwServiceNode;
+
+typedef struct {
+    guint32 id;
+    guint32 node_id;
+    gboolean is_output;
+    gboolean is_monitor;
+    gchar *channel;          // audio.channel (FL, FR, MONO, ...)
+} PwServicePort;
+
+typedef struct {
+    guint32 id;
+    guint32 output_node;
+    guint32 input_node;
+} PwServiceLink;
+
+/**
+ * Model change callbacks. Every member is optional. They run on the
+ * service thread with the loop locked and must not add or remove listeners.
+ */
+typedef struct {
+    void (*node_added)(const PwServiceNode *node, gpointer user_data);
+    void (*node_changed)(const PwServiceNode *node, guint changes, gpointer user_data);
+    void (*node_removed)(const PwServiceNode *node, gpointer user_data);
+    void (*port_added)(const PwServicePort *port, gpointer user_data);
+    void (*port_removed)(const PwServicePort *port, gpointer user_data);
+    // The core died: destroy streams/proxies made on it and drop model pointers
+    void (*connection_lost)(gpointer user_data);
+    // New core is up (model still empty; nodes and ports follow via *_added)
+    void (*reconnected)(gpointer user_data);
+} PwServiceEvents;
+
+/**
+ * Connect on first use (thread-safe) and enumerate the graph once.
+ *
+ * @return TRUE if the service is usable
+ */
+gboolean pw_service_ensure_connected(void);
+
+/**
+ * Disconnect and free the model. Call from the app's shutdown path after
+ * destroying every stream created on the shared core; remaining listeners
+ * are dropped without further callbacks.
+ */
+void pw_service_shutdown(void);
+
+/**
+ * Lock/unlock the service loop (recursive).
+ */
+void pw_service_lock(void);
+void pw_service_unlock(void);
+
+/**
+ * Shared objects for creating streams and links, and for invoking
+ * work on the loop or data loop. Valid after pw_service_ensure_connected().
+ */
+struct pw_core* pw_service_get_core(void);
+struct pw_context* pw_service_get_context(void);
+struct pw_loop* pw_service_get_loop(void);
+
+/**
+ * Subscribe to model changes. Existing nodes and ports are replayed
+ * through node_added/port_added before this returns.
+ *
+ * @param events Callbacks (must stay valid until removed)
+ * @param user_data Passed to every callback
+ * @return Listener ID for pw_service_remove_listener(), 0 if not connected
+ */
+guint pw_service_add_listener(const PwServiceEvents *events, gpointer user_data);
+
+/**
+ * Unsubscribe a listener.
+ */
+void pw_service_remove_listener(guint listener_id);
+
+/**
+ * Model access. Call with the service locked; pointers stay valid
+ * until the object is removed.
+ */
+GHashTable* pw_service_get_nodes(void);   // node id -> PwServiceNode*
+GHashTable* pw_service_get_ports(void);   // port id -> PwServicePort*
+GHashTable* pw_service_get_links(void);   // link id -> PwServiceLink*
+PwServiceNode* pw_service_get_node(guint32 id);
+PwServiceNode* pw_service_find_stream_by_serial(gint serial);
+gboolean pw_service_is_sink(guint32 id);
+
+#endif // PIPEWIRE_SERVICE_H
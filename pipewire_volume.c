@@ -1,20 +1,236 @@
 #include "pipewire_volume.h"
+#include "proc_tree.h"
+#include "pipewire_service.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <gio/gio.h>
+#include <pipewire/pipewire.h>
+#include <spa/param/audio/raw.h>
+#include <spa/param/props.h>
+#include <spa/pod/builder.h>
 
 /**
  * PipeWire Per-Application Volume Control Implementation
  *
- * Uses pactl (PipeWire-Pulse compatibility layer) to control per-application
- * volume via sink-inputs. This approach was chosen over libpipewire because:
- * 1. HyprWave already uses libpulse for the visualizer
- * 2. pactl works on all PipeWire systems with pipewire-pulse
- * 3. No new library dependencies required
- * 4. Simpler than async libpipewire event loop
+ * Two backends share the pw_* API:
+ * 1. Native: the shared PipeWire service (pipewire_service.c). It binds
+ *    playback stream nodes and subscribes their SPA_PARAM_Props, so reading
+ *    a volume is a model lookup and setting one is a single
+ *    pw_node_set_param() message. No fork/exec on the GTK main thread.
+ * 2. pactl: the original pipewire-pulse text parser, used only when the
+ *    native connection cannot be established.
+ *
+ * "Sink-input index" means the node's object.serial in both backends, which
+ * is what pipewire-pulse reports as the sink-input index.
  */
 
+// Native backend: the shared PipeWire service's live model
+static gboolean native_ensure_connected(void) {
+    return pw_service_ensure_connected();
+}
+
+static gint native_find_sink_input_by_pid(guint32 pid) {
+    gint found = -1;
+
+    pw_service_lock();
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, pw_service_get_nodes());
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        PwServiceNode *node = (PwServiceNode *)value;
+        if (node->kind == PW_SERVICE_NODE_STREAM && node->pid == pid) {
+            found = node->serial;
+            break;
+        }
+    }
+    pw_service_unlock();
+
+    if (found >= 0) {
+        g_print("PipeWire: Found sink-input #%d for PID %u\n", found, pid);
+    }
+    return found;
+}
+
+// One pass over the streams: the root PID wins, otherwise any PID in the set
+static gint native_find_sink_input_by_pids(GHashTable *pids, guint32 root_pid, guint32 *matched_pid) {
+    gint found = -1;
+
+    pw_service_lock();
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, pw_service_get_nodes());
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        PwServiceNode *node = (PwServiceNode *)value;
+        if (node->kind != PW_SERVICE_NODE_STREAM || node->pid == 0 ||
+            !g_hash_table_contains(pids, GUINT_TO_POINTER(node->pid))) continue;
+
+        if (found < 0 || node->pid == root_pid) {
+            found = node->serial;
+            *matched_pid = node->pid;
+        }
+        if (node->pid == root_pid) break;
+    }
+    pw_service_unlock();
+
+    return found;
+}
+
+static gint native_find_sink_input_by_app_name(const gchar *app_name) {
+    gint found = -1;
+    gchar *lower_name = g_ascii_strdown(app_name, -1);
+
+    pw_service_lock();
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, pw_service_get_nodes());
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        PwServiceNode *node = (PwServiceNode *)value;
+        if (node->kind != PW_SERVICE_NODE_STREAM || !node->app_name) continue;
+        gchar *lower_app = g_ascii_strdown(node->app_name, -1);
+        gboolean match = g_strstr_len(lower_app, -1, lower_name) != NULL;
+        g_free(lower_app);
+        if (match) {
+            found = node->serial;
+            break;
+        }
+    }
+    pw_service_unlock();
+
+    g_free(lower_name);
+    if (found >= 0) {
+        g_print("PipeWire: Found sink-input #%d by app name '%s'\n", found, app_name);
+    }
+    return found;
+}
+
+static gint native_find_sink_for_input(gint sink_input_index) {
+    gint found_sink = -1;
+
+    pw_service_lock();
+    PwServiceNode *node = pw_service_find_stream_by_serial(sink_input_index);
+    if (node) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, pw_service_get_links());
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            PwServiceLink *link = (PwServiceLink *)value;
+            if (link->output_node == node->id && pw_service_is_sink(link->input_node)) {
+                found_sink = (gint)link->input_node;
+                break;
+            }
+        }
+    }
+    pw_service_unlock();
+
+    return found_sink;
+}
+
+typedef struct {
+    PwVolumeChangedFunc func;
+    gpointer user_data;
+} VolumeWatch;
+
+// Loudest channel on the cubic (pactl %) scale; PipeWire stores linear gain
+static gdouble node_volume(const PwServiceNode *node) {
+    float linear = 0.0f;
+    for (guint32 i = 0; i < node->n_channels; i++) {
+        if (node->channel_volumes[i] > linear) linear = node->channel_volumes[i];
+    }
+    return cbrt(linear);
+}
+
+static void on_watched_node_changed(const PwServiceNode *node, guint changes, gpointer user_data) {
+    VolumeWatch *watch = (VolumeWatch *)user_data;
+    if (!(changes & PW_SERVICE_CHANGE_VOLUME) || node->kind != PW_SERVICE_NODE_STREAM) return;
+    watch->func(node->serial, node_volume(node), watch->user_data);
+}
+
+static const PwServiceEvents volume_watch_events = {
+    .node_changed = on_watched_node_changed,
+};
+
+// watch id -> VolumeWatch*
+static GHashTable *volume_watches;
+
+static gdouble native_get_volume(gint sink_input_index) {
+    gdouble volume = -1.0;
+
+    pw_service_lock();
+    PwServiceNode *node = pw_service_find_stream_by_serial(sink_input_index);
+    if (node && node->has_volume) {
+        // Report the loudest channel, like pactl's first-channel readout for balanced streams
+        volume = node_volume(node);
+    }
+    pw_service_unlock();
+
+    return volume;
+}
+
+static gboolean native_set_volume(gint sink_input_index, gdouble volume) {
+    gboolean success = FALSE;
+
+    pw_service_lock();
+    PwServiceNode *node = pw_service_find_stream_by_serial(sink_input_index);
+    if (node && node->proxy) {
+        guint32 n_channels = node->n_channels > 0 ? node->n_channels : 2;
+        float linear = (float)(volume * volume * volume);
+        float volumes[SPA_AUDIO_MAX_CHANNELS];
+        for (guint32 i = 0; i < n_channels; i++) volumes[i] = linear;
+
+        uint8_t buffer[1024];
+        struct spa_pod_builder b = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
+        struct spa_pod *param = spa_pod_builder_add_object(&b,
+            SPA_TYPE_OBJECT_Props, SPA_PARAM_Props,
+            SPA_PROP_channelVolumes, SPA_POD_Array(sizeof(float), SPA_TYPE_Float,
+                                                   n_channels, volumes));
+
+        success = pw_node_set_param(node->proxy, SPA_PARAM_Props, 0, param) >= 0;
+        if (success) {
+            // Optimistically update the model; the Props event will confirm it
+            for (guint32 i = 0; i < n_channels; i++) node->channel_volumes[i] = linear;
+            node->n_channels = n_channels;
+            node->has_volume = TRUE;
+        }
+    }
+    pw_service_unlock();
+
+    return success;
+}
+
+gboolean pw_volume_is_available(void) {
+    return native_ensure_connected() || pw_is_pactl_available();
+}
+
+guint pw_volume_watch(PwVolumeChangedFunc func, gpointer user_data) {
+    if (!func || !native_ensure_connected()) return 0;
+
+    VolumeWatch *watch = g_new0(VolumeWatch, 1);
+    watch->func = func;
+    watch->user_data = user_data;
+
+    guint id = pw_service_add_listener(&volume_watch_events, watch);
+    if (id == 0) {
+        g_free(watch);
+        return 0;
+    }
+
+    if (!volume_watches) {
+        volume_watches = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    }
+    g_hash_table_insert(volume_watches, GUINT_TO_POINTER(id), watch);
+    return id;
+}
+
+void pw_volume_unwatch(guint watch_id) {
+    if (watch_id == 0 || !volume_watches) return;
+
+    // Removing the listener takes the loop lock, so no callback is still running
+    pw_service_remove_listener(watch_id);
+    g_hash_table_remove(volume_watches, GUINT_TO_POINTER(watch_id));
+}
+
 gboolean pw_is_pactl_available(void) {
     gchar *stdout_str = NULL;
     gchar *stderr_str = NULL;
@@ -86,7 +302,7 @@ guint32 pw_extract_pid_from_bus_name(const gchar *mpris_bus_name) {
     return pid;
 }
 
-gint pw_find_sink_input_by_pid(guint32 pid) {
+static gint pactl_find_sink_input_by_pid(guint32 pid) {
     if (pid == 0) return -1;
 
     gchar *stdout_str = NULL;
@@ -144,7 +360,48 @@ gint pw_find_sink_input_by_pid(guint32 pid) {
     return found_index;
 }
 
-gint pw_find_sink_input_by_app_name(const gchar *app_name) {
+// Same as native_find_sink_input_by_pids, from a single "pactl list sink-inputs"
+static gint pactl_find_sink_input_by_pids(GHashTable *pids, guint32 root_pid, guint32 *matched_pid) {
+    gchar *stdout_str = NULL;
+    gint exit_status;
+
+    if (!g_spawn_command_line_sync("pactl list sink-inputs", &stdout_str, NULL, &exit_status, NULL) ||
+        exit_status != 0 || !stdout_str) {
+        g_free(stdout_str);
+        return -1;
+    }
+
+    const gchar *pid_key = "application.process.id = \"";
+    gint found_index = -1;
+    gint current_index = -1;
+
+    gchar **lines = g_strsplit(stdout_str, "\n", -1);
+    g_free(stdout_str);
+
+    for (gchar **line = lines; *line; line++) {
+        if (g_str_has_prefix(*line, "Sink Input #")) {
+            current_index = (gint)g_ascii_strtoll(*line + 12, NULL, 10);
+            continue;
+        }
+
+        gchar *pid_str = current_index >= 0 ? g_strstr_len(*line, -1, pid_key) : NULL;
+        if (!pid_str) continue;
+
+        guint32 pid = (guint32)g_ascii_strtoull(pid_str + strlen(pid_key), NULL, 10);
+        if (pid == 0 || !g_hash_table_contains(pids, GUINT_TO_POINTER(pid))) continue;
+
+        if (found_index < 0 || pid == root_pid) {
+            found_index = current_index;
+            *matched_pid = pid;
+        }
+        if (pid == root_pid) break;
+    }
+
+    g_strfreev(lines);
+    return found_index;
+}
+
+static gint pactl_find_sink_input_by_app_name(const gchar *app_name) {
     if (!app_name || !*app_name) return -1;
 
     gchar *stdout_str = NULL;
@@ -189,7 +446,7 @@ gint pw_find_sink_input_by_app_name(const gchar *app_name) {
     return found_index;
 }
 
-gint pw_find_sink_for_input(gint sink_input_index) {
+static gint pactl_find_sink_for_input(gint sink_input_index) {
     if (sink_input_index < 0) return -1;
 
     gchar *stdout_str = NULL;
@@ -234,60 +491,6 @@ gint pw_find_sink_for_input(gint sink_input_index) {
     return found_sink;
 }
 
-/**
- * Find sink-input by checking the main PID and all its child processes.
- * This handles Chromium-based apps where audio comes from a child subprocess.
- */
-static gint find_sink_input_in_process_tree(guint32 root_pid) {
-    // First try the root PID directly
-    gint result = pw_find_sink_input_by_pid(root_pid);
-    if (result >= 0) return result;
-
-    // Try to find child processes using pgrep
-    gchar *command = g_strdup_printf("pgrep -P %u", root_pid);
-    gchar *stdout_str = NULL;
-    gchar *stderr_str = NULL;
-    gint exit_status;
-    GError *error = NULL;
-
-    gboolean success = g_spawn_command_line_sync(
-        command, &stdout_str, &stderr_str, &exit_status, &error);
-
-    g_free(command);
-    g_free(stderr_str);
-    if (error) g_error_free(error);
-
-    if (!success || exit_status != 0 || !stdout_str) {
-        g_free(stdout_str);
-        return -1;
-    }
-
-    // Parse child PIDs and check each one
-    gchar **child_pids = g_strsplit(stdout_str, "\n", -1);
-    g_free(stdout_str);
-
-    for (gchar **pid_str = child_pids; *pid_str && **pid_str; pid_str++) {
-        guint32 child_pid = (guint32)g_ascii_strtoull(*pid_str, NULL, 10);
-        if (child_pid > 0) {
-            result = pw_find_sink_input_by_pid(child_pid);
-            if (result >= 0) {
-                g_print("PipeWire: Found sink-input via child PID %u\n", child_pid);
-                g_strfreev(child_pids);
-                return result;
-            }
-            // Recursively check grandchildren
-            result = find_sink_input_in_process_tree(child_pid);
-            if (result >= 0) {
-                g_strfreev(child_pids);
-                return result;
-            }
-        }
-    }
-
-    g_strfreev(child_pids);
-    return -1;
-}
-
 gint pw_find_sink_input_for_player(const gchar *mpris_bus_name) {
     guint32 pid = pw_extract_pid_from_bus_name(mpris_bus_name);
     if (pid == 0) {
@@ -296,10 +499,10 @@ gint pw_find_sink_input_for_player(const gchar *mpris_bus_name) {
     }
 
     // Search the entire process tree for a sink-input
-    return find_sink_input_in_process_tree(pid);
+    return pw_find_sink_input_in_process_tree(pid);
 }
 
-gdouble pw_get_volume(gint sink_input_index) {
+static gdouble pactl_get_volume(gint sink_input_index) {
     if (sink_input_index < 0) return -1.0;
 
     gchar *stdout_str = NULL;
@@ -367,7 +570,7 @@ gdouble pw_get_volume(gint sink_input_index) {
     return volume;
 }
 
-gboolean pw_set_volume(gint sink_input_index, gdouble volume) {
+static gboolean pactl_set_volume(gint sink_input_index, gdouble volume) {
     if (sink_input_index < 0) return FALSE;
 
     // Clamp volume to reasonable range (0-150% to allow some boost)
@@ -404,3 +607,139 @@ gboolean pw_set_volume(gint sink_input_index, gdouble volume) {
 
     return result && exit_status == 0;
 }
+
+gint pw_find_sink_input_by_pid(guint32 pid) {
+    if (pid == 0) return -1;
+    if (native_ensure_connected()) return native_find_sink_input_by_pid(pid);
+    return pactl_find_sink_input_by_pid(pid);
+}
+
+gint pw_find_sink_input_in_process_tree(guint32 root_pid) {
+    if (root_pid == 0) return -1;
+
+    // One /proc scan, then one pass over the streams against the whole subtree
+    ProcTree *tree = proc_tree_new();
+    GHashTable *pids = proc_tree_descendants(tree, root_pid);
+    guint32 matched_pid = 0;
+
+    gint found = native_ensure_connected()
+        ? native_find_sink_input_by_pids(pids, root_pid, &matched_pid)
+        : pactl_find_sink_input_by_pids(pids, root_pid, &matched_pid);
+
+    if (found >= 0) {
+        const gchar *comm = proc_tree_get_comm(tree, matched_pid);
+        g_print("PipeWire: Found sink-input #%d via PID %u (%s) in tree of %u (%u processes)\n",
+                found, matched_pid, comm ? comm : "?", root_pid, g_hash_table_size(pids));
+    }
+
+    g_hash_table_unref(pids);
+    proc_tree_free(tree);
+    return found;
+}
+
+gint pw_find_sink_input_by_app_name(const gchar *app_name) {
+    if (!app_name || !*app_name) return -1;
+    if (native_ensure_connected()) return native_find_sink_input_by_app_name(app_name);
+    return pactl_find_sink_input_by_app_name(app_name);
+}
+
+gint pw_find_sink_for_input(gint sink_input_index) {
+    if (sink_input_index < 0) return -1;
+    if (native_ensure_connected()) return native_find_sink_for_input(sink_input_index);
+    return pactl_find_sink_for_input(sink_input_index);
+}
+
+gdouble pw_get_volume(gint sink_input_index) {
+    if (sink_input_index < 0) return -1.0;
+    if (native_ensure_connected()) return native_get_volume(sink_input_index);
+    return pactl_get_volume(sink_input_index);
+}
+
+gboolean pw_set_volume(gint sink_input_index, gdouble volume) {
+    if (sink_input_index < 0) return FALSE;
+
+    // Clamp volume to reasonable range (0-150% to allow some boost)
+    if (volume < 0.0) volume = 0.0;
+    if (volume > 1.5) volume = 1.5;
+
+    if (native_ensure_connected()) return native_set_volume(sink_input_index, volume);
+    return pactl_set_volume(sink_input_index, volume);
+}
+
+void pw_player_target_free(PwPlayerTarget *target) {
+    if (!target) return;
+    g_free(target->bus_name);
+    g_free(target);
+}
+
+// Worker thread: every step may block on D-Bus, /proc or pactl
+static void resolve_player_thread(GTask *task, gpointer source_object,
+                                  gpointer task_data, GCancellable *cancellable) {
+    const gchar *bus_name = (const gchar *)task_data;
+    (void)source_object;
+    (void)cancellable;
+
+    PwPlayerTarget *target = g_new0(PwPlayerTarget, 1);
+    target->bus_name = g_strdup(bus_name);
+    target->sink_input = -1;
+    target->sink = -1;
+    target->volume = -1.0;
+
+    target->pid = pw_extract_pid_from_bus_name(bus_name);
+    if (g_task_return_error_if_cancelled(task)) {
+        pw_player_target_free(target);
+        return;
+    }
+
+    if (target->pid > 0) {
+        // One /proc scan covers Chromium/Electron child processes
+        target->sink_input = pw_find_sink_input_in_process_tree(target->pid);
+    }
+
+    // Fallback: match by application name (for ALSA players without process.id)
+    if (target->sink_input < 0) {
+        // Extract app name from "org.mpris.MediaPlayer2.qobuz-player" -> "qobuz-player"
+        const gchar *prefix = "org.mpris.MediaPlayer2.";
+        const gchar *app_name = bus_name;
+        if (g_str_has_prefix(bus_name, prefix)) {
+            app_name = bus_name + strlen(prefix);
+        }
+        target->sink_input = pw_find_sink_input_by_app_name(app_name);
+    }
+
+    if (g_task_return_error_if_cancelled(task)) {
+        pw_player_target_free(target);
+        return;
+    }
+
+    if (target->sink_input >= 0) {
+        target->sink = pw_find_sink_for_input(target->sink_input);
+        target->volume = pw_get_volume(target->sink_input);
+    }
+
+    g_task_return_pointer(task, target, (GDestroyNotify)pw_player_target_free);
+}
+
+void pw_resolve_player_async(const gchar *mpris_bus_name, GCancellable *cancellable,
+                             GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_source_tag(task, pw_resolve_player_async);
+    // A superseded lookup is never delivered, even if it finished first
+    g_task_set_return_on_cancel(task, TRUE);
+    g_task_set_task_data(task, g_strdup(mpris_bus_name), g_free);
+
+    if (!mpris_bus_name) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                                "No player bus name");
+        g_object_unref(task);
+        return;
+    }
+
+    g_task_run_in_thread(task, resolve_player_thread);
+    g_object_unref(task);
+}
+
+PwPlayerTarget* pw_resolve_player_finish(GAsyncResult *result, GError **error) {
+    g_return_val_if_fail(g_task_is_valid(result, NULL), NULL);
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
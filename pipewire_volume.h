@@ -2,12 +2,18 @@
 #define PIPEWIRE_VOLUME_H
 
 #include <glib.h>
+#include <gio/gio.h>
 
 /**
  * PipeWire Per-Application Volume Control
  *
  * Maps MPRIS players to their PipeWire sink-inputs by extracting
- * the PID from the D-Bus name and matching it against pactl output.
+ * the PID from the D-Bus name and matching it against the application.process.id
+ * of playback stream nodes.
+ *
+ * Volume is read and written natively through the shared PipeWire service
+ * (SPA_PARAM_Props channelVolumes on the stream node). If the service
+ * cannot connect, pactl is used as a fallback.
  *
  * This enables volume control for players that don't support MPRIS Volume
  * (like Roon, Chromium/Electron apps) by controlling their audio stream
@@ -33,6 +39,19 @@ gint pw_find_sink_input_for_player(const gchar *mpris_bus_name);
  */
 gint pw_find_sink_input_by_pid(guint32 pid);
 
+/**
+ * Find the PipeWire sink-input index for a PID or any of its descendants.
+ *
+ * Builds a process tree from one /proc scan and matches every stream's
+ * application.process.id against the subtree in a single pass, so
+ * Chromium/Electron players whose audio comes from a child process are
+ * found without spawning pgrep. The root PID's own stream is preferred.
+ *
+ * @param root_pid The player's process ID
+ * @return The sink-input index, or -1 if not found
+ */
+gint pw_find_sink_input_in_process_tree(guint32 root_pid);
+
 /**
  * Get the current volume of a PipeWire sink-input.
  *
@@ -65,7 +84,7 @@ guint32 pw_extract_pid_from_bus_name(const gchar *mpris_bus_name);
 /**
  * Find the PipeWire sink-input index by application name substring.
  *
- * Matches against application.name property in pactl output.
+ * Matches against the application.name property of playback streams.
  * Useful for ALSA-based players that don't set application.process.id.
  *
  * @param app_name Substring to match in application.name (e.g., "qobuz-player")
@@ -81,6 +100,75 @@ gint pw_find_sink_input_by_app_name(const gchar *app_name);
  */
 gint pw_find_sink_for_input(gint sink_input_index);
 
+/**
+ * Called when a sink-input's volume changes, whoever changed it.
+ * Runs on the PipeWire thread; hop to the main loop before touching GTK.
+ *
+ * @param sink_input_index The sink-input whose volume changed
+ * @param volume New volume as a fraction (cubic scale, like pw_get_volume())
+ */
+typedef void (*PwVolumeChangedFunc)(gint sink_input_index, gdouble volume, gpointer user_data);
+
+/**
+ * Watch every playback stream's volume (native backend only).
+ *
+ * @return Watch ID for pw_volume_unwatch(), or 0 if volume events are unavailable
+ */
+guint pw_volume_watch(PwVolumeChangedFunc func, gpointer user_data);
+
+/**
+ * Stop a volume watch. No callback runs after this returns.
+ */
+void pw_volume_unwatch(guint watch_id);
+
+/**
+ * Audio stream resolved for an MPRIS player.
+ */
+typedef struct {
+    gchar *bus_name;    // MPRIS bus name the lookup was started for
+    guint32 pid;        // Player PID, 0 if unknown
+    gint sink_input;    // Sink-input index, -1 if the player has no stream yet
+    gint sink;          // Sink the stream plays into, -1 if unknown
+    gdouble volume;     // The stream's volume (like pw_get_volume()), -1.0 if unknown
+} PwPlayerTarget;
+
+/**
+ * Free a resolved player target.
+ */
+void pw_player_target_free(PwPlayerTarget *target);
+
+/**
+ * Resolve an MPRIS player to its PID, sink-input and sink on a worker thread.
+ *
+ * Runs pw_extract_pid_from_bus_name(), the process-tree and app-name
+ * sink-input lookups, pw_find_sink_for_input() and pw_get_volume() off
+ * the main thread.
+ * Cancelling stops the lookup between steps; the callback then receives
+ * G_IO_ERROR_CANCELLED. The callback runs in the caller's main context.
+ *
+ * @param mpris_bus_name The full D-Bus name of the MPRIS player
+ * @param cancellable Optional cancellable (cancel it when the player changes again)
+ * @param callback Called with the result
+ * @param user_data Passed to callback
+ */
+void pw_resolve_player_async(const gchar *mpris_bus_name, GCancellable *cancellable,
+                             GAsyncReadyCallback callback, gpointer user_data);
+
+/**
+ * Finish pw_resolve_player_async().
+ *
+ * @return The resolved target (free with pw_player_target_free()), or NULL with error set
+ */
+PwPlayerTarget* pw_resolve_player_finish(GAsyncResult *result, GError **error);
+
+/**
+ * Check if any volume backend (native PipeWire or pactl) is usable.
+ * Connects the native backend on first use.
+ *
+ * @return TRUE if per-application volume can be controlled
+ */
+gboolean pw_volume_is_available(void);
+
 /**
  * Check if pactl is available on the system.
  *
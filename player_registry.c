@@ -0,0 +1,265 @@
+#include "player_registry.h"
+#include "mpris_player.h"
+
+#define MPRIS_NAMESPACE "org.mpris.MediaPlayer2"
+#define MPRIS_PREFIX MPRIS_NAMESPACE "."
+
+typedef struct {
+    gchar *bus_name;
+    GCancellable *cancellable;  // Proxy creation, cancelled if the name vanishes
+    gboolean initial;           // Part of the startup listing
+} PendingPlayer;
+
+static GDBusConnection *bus = NULL;
+static guint name_watch_id = 0;
+static const PlayerRegistryEvents *listener = NULL;
+static gpointer listener_data = NULL;
+
+static GPtrArray *players = NULL;    // Listed bus names, discovery order
+static GHashTable *pending = NULL;   // bus name -> PendingPlayer* (connecting)
+static gboolean listing_done = FALSE;
+static guint initial_outstanding = 0;
+static gboolean registry_ready = FALSE;
+
+// ========================================
+// PLAYER FILTERING
+// ========================================
+
+// Check if a D-Bus name should be excluded from player list
+static gboolean is_excluded_player(const gchar *name) {
+    // Exclude playerctld (it's a proxy, not a real player)
+    if (g_str_has_suffix(name, ".playerctld")) return TRUE;
+
+    // Exclude common browsers (poor MPRIS metadata)
+    const gchar *excluded[] = {
+        ".firefox", ".chromium", ".chrome", ".brave",
+        ".vivaldi", ".opera", ".edge", NULL
+    };
+
+    for (const gchar **ex = excluded; *ex; ex++) {
+        if (g_str_has_suffix(name, *ex)) return TRUE;
+    }
+    return FALSE;
+}
+
+// Check if chromium-based player is allowed (e.g., Cider, tidal-hifi)
+// For chromium.instance* names, check the cached Identity
+static gboolean is_allowed_player(const gchar *name, const gchar *identity) {
+    // Allow specific names directly in the D-Bus name
+    const gchar *allowed[] = {
+        "Cider", "tidal", "hifi", "qobuz", "spotify", "Plexamp", "roon", NULL
+    };
+
+    for (const gchar **a = allowed; *a; a++) {
+        if (g_strstr_len(name, -1, *a)) return TRUE;
+    }
+
+    // If it's a chromium instance, check if Identity contains allowed app names
+    if (g_strstr_len(name, -1, "chromium.instance") ||
+        g_strstr_len(name, -1, "chrome.instance")) {
+        if (identity) {
+            for (const gchar **a = allowed; *a; a++) {
+                if (g_strstr_len(identity, -1, *a)) return TRUE;
+            }
+        }
+        return FALSE;  // Unknown chromium instance, filter it
+    }
+
+    // Block generic browser names
+    if (g_strstr_len(name, -1, "chromium") ||
+        g_strstr_len(name, -1, "chrome") ||
+        g_strstr_len(name, -1, "firefox")) {
+        return FALSE;
+    }
+
+    return TRUE;  // Allow non-chromium players
+}
+
+// ========================================
+// REGISTRY
+// ========================================
+
+static void pending_player_free(gpointer data) {
+    PendingPlayer *pending_player = (PendingPlayer *)data;
+    g_object_unref(pending_player->cancellable);
+    g_free(pending_player->bus_name);
+    g_free(pending_player);
+}
+
+static void check_ready(void) {
+    if (registry_ready || !listing_done || initial_outstanding > 0) return;
+
+    registry_ready = TRUE;
+    g_print("✓ Player registry ready (%u player%s)\n",
+            players->len, players->len == 1 ? "" : "s");
+    if (listener && listener->ready) listener->ready(listener_data);
+}
+
+static void on_player_resolved(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    MprisPlayer *player = mpris_player_get_finish(result, &error);
+
+    // The name vanished while connecting; untrack_name already cleaned up
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_error_free(error);
+        return;
+    }
+
+    PendingPlayer *pending_player = (PendingPlayer *)user_data;
+    gboolean initial = pending_player->initial;
+    gchar *bus_name = g_strdup(pending_player->bus_name);
+    g_hash_table_remove(pending, bus_name);
+
+    if (player && is_allowed_player(bus_name, player->identity)) {
+        g_ptr_array_add(players, bus_name);
+        if (!initial) g_print("✓ New player detected: %s\n", bus_name);
+        if (listener && listener->player_added) listener->player_added(bus_name, listener_data);
+    } else {
+        if (error) {
+            g_printerr("Failed to connect to player %s: %s\n", bus_name, error->message);
+            g_error_free(error);
+        }
+        g_free(bus_name);
+    }
+
+    if (initial) {
+        initial_outstanding--;
+        check_ready();
+    }
+}
+
+static void track_name(const gchar *name, gboolean initial) {
+    if (!g_str_has_prefix(name, MPRIS_PREFIX) || is_excluded_player(name)) return;
+    if (g_hash_table_contains(pending, name) || player_registry_index_of(name) >= 0) return;
+
+    PendingPlayer *pending_player = g_new0(PendingPlayer, 1);
+    pending_player->bus_name = g_strdup(name);
+    pending_player->cancellable = g_cancellable_new();
+    pending_player->initial = initial;
+    g_hash_table_insert(pending, pending_player->bus_name, pending_player);
+    if (initial) initial_outstanding++;
+
+    // Connect now so the filter sees Identity and switching later is instant
+    mpris_player_get_async(name, pending_player->cancellable, on_player_resolved, pending_player);
+}
+
+static void untrack_name(const gchar *name) {
+    gboolean was_initial = FALSE;
+
+    PendingPlayer *pending_player = g_hash_table_lookup(pending, name);
+    if (pending_player) {
+        was_initial = pending_player->initial;
+        g_cancellable_cancel(pending_player->cancellable);
+        g_hash_table_remove(pending, name);
+        if (was_initial) initial_outstanding--;
+    }
+
+    gint index = player_registry_index_of(name);
+    if (index >= 0) {
+        gchar *bus_name = g_ptr_array_steal_index(players, index);
+        if (listener && listener->player_removed) listener->player_removed(bus_name, listener_data);
+        g_free(bus_name);
+    }
+
+    // Its cached proxies are useless once the owner has left the bus
+    mpris_player_forget(name);
+
+    if (was_initial) check_ready();
+}
+
+static void on_name_owner_changed(GDBusConnection *connection,
+                                  const gchar *sender_name,
+                                  const gchar *object_path,
+                                  const gchar *interface_name,
+                                  const gchar *signal_name,
+                                  GVariant *parameters,
+                                  gpointer user_data) {
+    const gchar *name;
+    const gchar *old_owner;
+    const gchar *new_owner;
+    g_variant_get(parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
+
+    // An owner handover is a disappearance followed by an appearance
+    if (old_owner[0] != '\0') untrack_name(name);
+    if (new_owner[0] != '\0') track_name(name, FALSE);
+}
+
+static void on_list_names(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    GVariant *reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+
+    if (reply) {
+        GVariantIter *iter;
+        const gchar *name;
+        g_variant_get(reply, "(as)", &iter);
+        while (g_variant_iter_loop(iter, "&s", &name)) {
+            track_name(name, TRUE);
+        }
+        g_variant_iter_free(iter);
+        g_variant_unref(reply);
+    } else {
+        g_printerr("Failed to list D-Bus names: %s\n", error->message);
+        g_error_free(error);
+    }
+
+    listing_done = TRUE;
+    check_ready();
+}
+
+gboolean player_registry_start(const PlayerRegistryEvents *events, gpointer user_data) {
+    if (bus) return TRUE;
+
+    // GApplication has already connected to the session bus, so this does not block
+    bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
+    if (!bus) return FALSE;
+
+    listener = events;
+    listener_data = user_data;
+    players = g_ptr_array_new_with_free_func(g_free);
+    pending = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, pending_player_free);
+
+    // Subscribe before listing: signals sent before the ListNames reply arrive
+    // before it, so no player can slip between the two
+    name_watch_id = g_dbus_connection_signal_subscribe(
+        bus,
+        "org.freedesktop.DBus",
+        "org.freedesktop.DBus",
+        "NameOwnerChanged",
+        "/org/freedesktop/DBus",
+        MPRIS_NAMESPACE,
+        G_DBUS_SIGNAL_FLAGS_MATCH_ARG0_NAMESPACE,
+        on_name_owner_changed,
+        NULL,
+        NULL
+    );
+
+    g_dbus_connection_call(bus, "org.freedesktop.DBus", "/org/freedesktop/DBus",
+                           "org.freedesktop.DBus", "ListNames", NULL,
+                           G_VARIANT_TYPE("(as)"), G_DBUS_CALL_FLAGS_NONE, -1,
+                           NULL, on_list_names, NULL);
+
+    g_print("✓ D-Bus name watcher enabled\n");
+    return TRUE;
+}
+
+gboolean player_registry_is_ready(void) {
+    return registry_ready;
+}
+
+guint player_registry_get_count(void) {
+    return players ? players->len : 0;
+}
+
+const gchar* player_registry_get(guint index) {
+    if (!players || index >= players->len) return NULL;
+    return g_ptr_array_index(players, index);
+}
+
+gint player_registry_index_of(const gchar *bus_name) {
+    if (!players || !bus_name) return -1;
+
+    for (guint i = 0; i < players->len; i++) {
+        if (g_strcmp0(g_ptr_array_index(players, i), bus_name) == 0) return (gint)i;
+    }
+    return -1;
+}
@@ -0,0 +1,60 @@
+#ifndef PLAYER_REGISTRY_H
+#define PLAYER_REGISTRY_H
+
+#include <gio/gio.h>
+
+/**
+ * MPRIS Player Registry
+ *
+ * Incremental list of usable MPRIS players. One asynchronous ListNames
+ * call seeds it at startup. After that it follows NameOwnerChanged for
+ * the org.mpris.MediaPlayer2 namespace. It never polls the bus.
+ *
+ * A player is listed once its proxies are cached (see mpris_player.h).
+ * The proxies supply its Identity for filtering (Chromium instances)
+ * and its capabilities. Switching to a listed player therefore needs no
+ * D-Bus round-trip. Excluded names (playerctld, plain browsers) are never
+ * connected.
+ *
+ * Use from the main thread only.
+ */
+
+/**
+ * Registry callbacks. Every member is optional.
+ */
+typedef struct {
+    void (*ready)(gpointer user_data);  // Startup listing done and every initial player resolved
+    void (*player_added)(const gchar *bus_name, gpointer user_data);
+    void (*player_removed)(const gchar *bus_name, gpointer user_data);
+} PlayerRegistryEvents;
+
+/**
+ * Subscribe to NameOwnerChanged and start the initial listing.
+ *
+ * @param events Callbacks (must stay valid while the registry runs)
+ * @param user_data Passed to every callback
+ * @return TRUE if the session bus is available
+ */
+gboolean player_registry_start(const PlayerRegistryEvents *events, gpointer user_data);
+
+/**
+ * TRUE once the startup listing has been resolved.
+ */
+gboolean player_registry_is_ready(void);
+
+/**
+ * Number of listed players.
+ */
+guint player_registry_get_count(void);
+
+/**
+ * Bus name of the player at index (discovery order), or NULL.
+ */
+const gchar* player_registry_get(guint index);
+
+/**
+ * Position of a bus name in the list, or -1 if it is not listed.
+ */
+gint player_registry_index_of(const gchar *bus_name);
+
+#endif // PLAYER_REGISTRY_H
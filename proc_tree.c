@@ -0,0 +1,104 @@
+#include "proc_tree.h"
+#include <stdio.h>
+#include <string.h>
+
+static void free_child_array(gpointer data) {
+    g_array_free((GArray *)data, TRUE);
+}
+
+// Parse /proc/<pid>/stat - format: pid (comm) state ppid ...
+// comm may itself contain spaces and parentheses, so split on the last ')'
+static gboolean read_stat(const gchar *pid_name, guint32 *ppid, gchar **comm) {
+    gchar *stat_path = g_build_filename("/proc", pid_name, "stat", NULL);
+    gchar *contents = NULL;
+    gboolean ok = g_file_get_contents(stat_path, &contents, NULL, NULL);
+    g_free(stat_path);
+    if (!ok) return FALSE;  // Process exited during the scan
+
+    gchar *open_paren = strchr(contents, '(');
+    gchar *close_paren = strrchr(contents, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren) {
+        g_free(contents);
+        return FALSE;
+    }
+
+    guint32 parent = 0;
+    if (sscanf(close_paren + 2, "%*c %u", &parent) != 1) {
+        g_free(contents);
+        return FALSE;
+    }
+
+    *ppid = parent;
+    *comm = g_strndup(open_paren + 1, close_paren - open_paren - 1);
+    g_free(contents);
+    return TRUE;
+}
+
+ProcTree* proc_tree_new(void) {
+    ProcTree *tree = g_new0(ProcTree, 1);
+    tree->children_of = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                              NULL, free_child_array);
+    tree->comm_of = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+    GDir *proc = g_dir_open("/proc", 0, NULL);
+    if (!proc) return tree;
+
+    const gchar *name;
+    while ((name = g_dir_read_name(proc)) != NULL) {
+        if (!g_ascii_isdigit(name[0])) continue;
+
+        guint32 pid = (guint32)g_ascii_strtoull(name, NULL, 10);
+        guint32 ppid = 0;
+        gchar *comm = NULL;
+        if (pid == 0 || !read_stat(name, &ppid, &comm)) continue;
+
+        g_hash_table_insert(tree->comm_of, GUINT_TO_POINTER(pid), comm);
+
+        GArray *children = g_hash_table_lookup(tree->children_of, GUINT_TO_POINTER(ppid));
+        if (!children) {
+            children = g_array_new(FALSE, FALSE, sizeof(guint32));
+            g_hash_table_insert(tree->children_of, GUINT_TO_POINTER(ppid), children);
+        }
+        g_array_append_val(children, pid);
+    }
+
+    g_dir_close(proc);
+    return tree;
+}
+
+void proc_tree_free(ProcTree *tree) {
+    if (!tree) return;
+    g_hash_table_destroy(tree->children_of);
+    g_hash_table_destroy(tree->comm_of);
+    g_free(tree);
+}
+
+GHashTable* proc_tree_descendants(const ProcTree *tree, guint32 root_pid) {
+    GHashTable *set = g_hash_table_new(g_direct_hash, g_direct_equal);
+    if (root_pid == 0) return set;
+
+    // Breadth-first over the children index
+    GArray *queue = g_array_new(FALSE, FALSE, sizeof(guint32));
+    g_array_append_val(queue, root_pid);
+    g_hash_table_add(set, GUINT_TO_POINTER(root_pid));
+
+    for (guint i = 0; i < queue->len; i++) {
+        guint32 pid = g_array_index(queue, guint32, i);
+        GArray *children = g_hash_table_lookup(tree->children_of, GUINT_TO_POINTER(pid));
+        if (!children) continue;
+
+        for (guint j = 0; j < children->len; j++) {
+            guint32 child = g_array_index(children, guint32, j);
+            if (g_hash_table_add(set, GUINT_TO_POINTER(child))) {
+                g_array_append_val(queue, child);
+            }
+        }
+    }
+
+    g_array_free(queue, TRUE);
+    return set;
+}
+
+const gchar* proc_tree_get_comm(const ProcTree *tree, guint32 pid) {
+    return g_hash_table_lookup(tree->comm_of, GUINT_TO_POINTER(pid));
+}
@@ -0,0 +1,49 @@
+#ifndef PROC_TREE_H
+#define PROC_TREE_H
+
+#include <glib.h>
+
+/**
+ * Process Tree Index
+ *
+ * Snapshot of the process tree built from a single scan of /proc
+ * (pid -> ppid, comm). Used to map a player's PID to the helper
+ * processes that actually own its audio stream (Chromium/Electron
+ * render processes, sandboxed players) without spawning pgrep once
+ * per tree level.
+ *
+ * A snapshot is not updated; build a new one when processes may have
+ * changed (e.g. on player switch or when playback starts).
+ */
+
+typedef struct {
+    GHashTable *children_of; // ppid -> GArray of child pids
+    GHashTable *comm_of;     // pid -> comm (process name)
+} ProcTree;
+
+/**
+ * Scan /proc once and index every process.
+ *
+ * @return A new snapshot, free with proc_tree_free()
+ */
+ProcTree* proc_tree_new(void);
+
+/**
+ * Free a process tree snapshot.
+ */
+void proc_tree_free(ProcTree *tree);
+
+/**
+ * Collect root_pid and all of its descendants.
+ *
+ * @param root_pid Root of the subtree
+ * @return Set of PIDs (GUINT_TO_POINTER keys), free with g_hash_table_unref()
+ */
+GHashTable* proc_tree_descendants(const ProcTree *tree, guint32 root_pid);
+
+/**
+ * Process name (comm) of a PID in the snapshot, or NULL.
+ */
+const gchar* proc_tree_get_comm(const ProcTree *tree, guint32 pid);
+
+#endif // PROC_TREE_H
@@ -0,0 +1,240 @@
+#include "spectrum.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * Real FFT via the "half-length complex" trick:
+ * the N real samples are packed as N/2 complex values (even -> re, odd -> im),
+ * transformed with an iterative radix-2 FFT, and then split back into the
+ * N/2 + 1 bins of the real spectrum. This halves the work of a full complex FFT.
+ */
+
+guint spectrum_normalize_fft_size(gint fft_size) {
+    guint size = SPECTRUM_MIN_FFT_SIZE;
+    while (size < (guint)MAX(fft_size, 0) && size < SPECTRUM_MAX_FFT_SIZE) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static void build_band_edges(Spectrum *s) {
+    guint half = s->fft_size / 2;
+    gdouble nyquist = s->sample_rate / 2.0;
+    gdouble f_min = SPECTRUM_MIN_FREQ;
+    gdouble f_max = MIN(SPECTRUM_MAX_FREQ, nyquist * 0.95);
+    gdouble bin_hz = (gdouble)s->sample_rate / s->fft_size;
+
+    for (guint i = 0; i < s->n_bands; i++) {
+        gdouble lo = f_min * pow(f_max / f_min, (gdouble)i / s->n_bands);
+        gdouble hi = f_min * pow(f_max / f_min, (gdouble)(i + 1) / s->n_bands);
+
+        guint start = (guint)floor(lo / bin_hz);
+        guint end = (guint)ceil(hi / bin_hz);
+
+        // Skip DC, stay below Nyquist, always cover at least one bin
+        if (start < 1) start = 1;
+        if (start > half - 1) start = half - 1;
+        if (end <= start) end = start + 1;
+        if (end > half) end = half;
+
+        s->band_start[i] = start;
+        s->band_end[i] = end;
+    }
+}
+
+Spectrum* spectrum_new(guint fft_size, guint sample_rate, guint n_bands) {
+    Spectrum *s = g_new0(Spectrum, 1);
+    s->fft_size = spectrum_normalize_fft_size((gint)fft_size);
+    s->sample_rate = sample_rate > 0 ? sample_rate : 48000;
+    s->n_bands = n_bands;
+
+    guint n = s->fft_size;
+    guint m = n / 2;
+
+    s->window = g_new(float, n);
+    s->twiddle_re = g_new(float, m / 2);
+    s->twiddle_im = g_new(float, m / 2);
+    s->split_re = g_new(float, m);
+    s->split_im = g_new(float, m);
+    s->bitrev = g_new(guint, m);
+    s->band_start = g_new0(guint, n_bands);
+    s->band_end = g_new0(guint, n_bands);
+    s->history = g_new0(float, n);
+    s->re = g_new0(float, m);
+    s->im = g_new0(float, m);
+
+    // Hann window
+    for (guint i = 0; i < n; i++) {
+        s->window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / (n - 1)));
+    }
+
+    // Twiddles for the N/2-point complex FFT: e^(-2*pi*i*j/M)
+    for (guint j = 0; j < m / 2; j++) {
+        s->twiddle_re[j] = (float)cos(2.0 * M_PI * j / m);
+        s->twiddle_im[j] = (float)-sin(2.0 * M_PI * j / m);
+    }
+
+    // Twiddles for the real split step: e^(-2*pi*i*k/N)
+    for (guint k = 0; k < m; k++) {
+        s->split_re[k] = (float)cos(2.0 * M_PI * k / n);
+        s->split_im[k] = (float)-sin(2.0 * M_PI * k / n);
+    }
+
+    // Bit-reversal permutation for M points
+    guint bits = 0;
+    while ((1u << bits) < m) bits++;
+    for (guint i = 0; i < m; i++) {
+        guint r = 0;
+        for (guint b = 0; b < bits; b++) {
+            if (i & (1u << b)) r |= 1u << (bits - 1 - b);
+        }
+        s->bitrev[i] = r;
+    }
+
+    build_band_edges(s);
+
+    return s;
+}
+
+void spectrum_free(Spectrum *s) {
+    if (!s) return;
+    g_free(s->window);
+    g_free(s->twiddle_re);
+    g_free(s->twiddle_im);
+    g_free(s->split_re);
+    g_free(s->split_im);
+    g_free(s->bitrev);
+    g_free(s->band_start);
+    g_free(s->band_end);
+    g_free(s->history);
+    g_free(s->re);
+    g_free(s->im);
+    g_free(s);
+}
+
+void spectrum_reset(Spectrum *s) {
+    if (!s) return;
+    memset(s->history, 0, s->fft_size * sizeof(float));
+    s->history_pos = 0;
+    s->pending = 0;
+}
+
+void spectrum_push(Spectrum *s, const float *samples, gsize n_samples) {
+    guint n = s->fft_size;
+
+    // Only the newest N samples can influence the next transform
+    if (n_samples > n) {
+        samples += n_samples - n;
+        n_samples = n;
+    }
+
+    gsize first = MIN(n_samples, (gsize)(n - s->history_pos));
+    memcpy(s->history + s->history_pos, samples, first * sizeof(float));
+    memcpy(s->history, samples + first, (n_samples - first) * sizeof(float));
+    s->history_pos = (guint)((s->history_pos + n_samples) % n);
+
+    if (s->pending < G_MAXUINT - n_samples) {
+        s->pending += (guint)n_samples;
+    }
+}
+
+gsize spectrum_peek_recent(const Spectrum *s, gsize n_samples,
+                           const float **first, gsize *first_len,
+                           const float **second, gsize *second_len) {
+    guint n = s->fft_size;
+    gsize count = MIN(n_samples, (gsize)n);
+    guint start = (guint)((s->history_pos + n - count) % n);
+
+    *first = s->history + start;
+    *first_len = MIN(count, (gsize)(n - start));
+    *second = s->history;
+    *second_len = count - *first_len;
+    return count;
+}
+
+guint spectrum_pending(const Spectrum *s) {
+    return s->pending;
+}
+
+void spectrum_mark_consumed(Spectrum *s) {
+    s->pending = 0;
+}
+
+// In-place iterative radix-2 FFT over s->re / s->im (N/2 points)
+static void fft_complex(Spectrum *s) {
+    guint m = s->fft_size / 2;
+    float *re = s->re;
+    float *im = s->im;
+
+    for (guint i = 0; i < m; i++) {
+        guint j = s->bitrev[i];
+        if (j > i) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (guint len = 2; len <= m; len <<= 1) {
+        guint half = len >> 1;
+        guint step = m / len;
+        for (guint i = 0; i < m; i += len) {
+            for (guint j = 0; j < half; j++) {
+                float wr = s->twiddle_re[j * step];
+                float wi = s->twiddle_im[j * step];
+                guint a = i + j;
+                guint b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+void spectrum_compute(Spectrum *s, float *bands) {
+    guint n = s->fft_size;
+    guint m = n / 2;
+
+    // Unroll the ring (oldest sample first), window, and pack even/odd as re/im
+    guint pos = s->history_pos;
+    for (guint i = 0; i < m; i++) {
+        guint i0 = 2 * i;
+        guint i1 = i0 + 1;
+        s->re[i] = s->history[(pos + i0) & (n - 1)] * s->window[i0];
+        s->im[i] = s->history[(pos + i1) & (n - 1)] * s->window[i1];
+    }
+
+    fft_complex(s);
+
+    // Hann coherent gain is 0.5, so a full-scale sine peaks at N/4
+    float scale = 4.0f / n;
+
+    for (guint b = 0; b < s->n_bands; b++) {
+        float peak = 0.0f;
+        for (guint k = s->band_start[b]; k < s->band_end[b]; k++) {
+            // Split Z[k] and Z[M-k] back into the real spectrum bin X[k]
+            guint mk = (m - k) & (m - 1);
+            float a = s->re[k], bi = s->im[k];
+            float c = s->re[mk], d = s->im[mk];
+
+            float er = 0.5f * (a + c);
+            float ei = 0.5f * (bi - d);
+            float or_ = 0.5f * (bi + d);
+            float oi = -0.5f * (a - c);
+
+            float wr = s->split_re[k];
+            float wi = s->split_im[k];
+            float xr = er + (wr * or_ - wi * oi);
+            float xi = ei + (wr * oi + wi * or_);
+
+            float mag = sqrtf(xr * xr + xi * xi) * scale;
+            if (mag > peak) peak = mag;
+        }
+        bands[b] = peak;
+    }
+
+    s->pending = 0;
+}
@@ -0,0 +1,111 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <glib.h>
+
+/**
+ * Spectrum Analyzer
+ *
+ * Windowed real FFT over a sliding history of mono samples, aggregated
+ * into log-spaced frequency bands. All tables (Hann window, twiddles,
+ * bit-reversal, band edges) are precomputed in spectrum_new(), so
+ * spectrum_push() and spectrum_compute() never allocate and are safe
+ * to call from the PipeWire RT thread.
+ */
+
+#define SPECTRUM_MIN_FFT_SIZE 256
+#define SPECTRUM_MAX_FFT_SIZE 8192
+#define SPECTRUM_DEFAULT_FFT_SIZE 2048
+
+#define SPECTRUM_MIN_FREQ 40.0
+#define SPECTRUM_MAX_FREQ 16000.0
+
+typedef struct {
+    guint fft_size;          // N real samples per transform (power of two)
+    guint sample_rate;
+    guint n_bands;
+
+    // Precomputed tables
+    float *window;           // N Hann coefficients
+    float *twiddle_re;       // N/4 twiddles for the N/2-point complex FFT
+    float *twiddle_im;
+    float *split_re;         // N/2 twiddles for the real-FFT split step
+    float *split_im;
+    guint *bitrev;           // N/2 bit-reversal permutation
+    guint *band_start;       // First FFT bin of each band
+    guint *band_end;         // One past the last FFT bin of each band
+
+    // Sliding history (ring buffer of the last N mono samples)
+    float *history;
+    guint history_pos;
+    guint pending;           // Samples pushed since the last transform
+
+    // Work buffers
+    float *re;
+    float *im;
+} Spectrum;
+
+/**
+ * Create a spectrum analyzer.
+ *
+ * @param fft_size FFT length; rounded to a power of two within
+ *                 SPECTRUM_MIN_FFT_SIZE..SPECTRUM_MAX_FFT_SIZE
+ * @param sample_rate Sample rate of the pushed audio in Hz
+ * @param n_bands Number of log-spaced output bands
+ * @return A new analyzer, free with spectrum_free()
+ */
+Spectrum* spectrum_new(guint fft_size, guint sample_rate, guint n_bands);
+
+/**
+ * Free a spectrum analyzer.
+ */
+void spectrum_free(Spectrum *spectrum);
+
+/**
+ * Normalize a requested FFT size to a supported power of two.
+ */
+guint spectrum_normalize_fft_size(gint fft_size);
+
+/**
+ * Append mono samples to the sliding history.
+ *
+ * @param samples Mono samples
+ * @param n_samples Number of samples
+ */
+void spectrum_push(Spectrum *spectrum, const float *samples, gsize n_samples);
+
+/**
+ * The newest samples of the history, oldest first, without copying. The
+ * ring may wrap, so they come back as up to two runs.
+ *
+ * @param n_samples How many samples are wanted (at most fft_size are kept)
+ * @return Number of samples in first + second
+ */
+gsize spectrum_peek_recent(const Spectrum *spectrum, gsize n_samples,
+                           const float **first, gsize *first_len,
+                           const float **second, gsize *second_len);
+
+/**
+ * Number of samples pushed since the last spectrum_compute().
+ */
+guint spectrum_pending(const Spectrum *spectrum);
+
+/**
+ * Discard the pending count without transforming (e.g. during silence).
+ */
+void spectrum_mark_consumed(Spectrum *spectrum);
+
+/**
+ * Transform the current history and write one magnitude per band.
+ * A full-scale sine yields a magnitude of roughly 1.0.
+ *
+ * @param bands Output array of n_bands values
+ */
+void spectrum_compute(Spectrum *spectrum, float *bands);
+
+/**
+ * Clear the sample history (e.g. when the capture target changes).
+ */
+void spectrum_reset(Spectrum *spectrum);
+
+#endif // SPECTRUM_H
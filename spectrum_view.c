@@ -0,0 +1,174 @@
+#include "spectrum_view.h"
+
+#define SPECTRUM_VIEW_MIN_EXTENT 1
+#define SPECTRUM_VIEW_LEVEL_FLOOR 0.01f
+
+struct _HyprwaveSpectrumView {
+    GtkWidget parent_instance;
+
+    GtkWidget *bar_style;      // Internal ".visualizer-bar" node, drawn once per bar via a transform
+    gboolean is_vertical;
+    guint n_bars;
+    gint max_extent;
+    gint node_extent;          // Length bar_style is allocated at (a full-height bar)
+    gint *extents;             // Current bar lengths in pixels
+};
+
+G_DEFINE_FINAL_TYPE(HyprwaveSpectrumView, hyprwave_spectrum_view, GTK_TYPE_WIDGET)
+
+static void hyprwave_spectrum_view_measure(GtkWidget *widget, GtkOrientation orientation,
+                                           int for_size, int *minimum, int *natural,
+                                           int *minimum_baseline, int *natural_baseline) {
+    HyprwaveSpectrumView *self = HYPRWAVE_SPECTRUM_VIEW(widget);
+    (void)for_size;
+
+    // Bars grow along the "extent" axis; the other axis is shared evenly
+    gboolean along_extent = self->is_vertical ? orientation == GTK_ORIENTATION_HORIZONTAL
+                                              : orientation == GTK_ORIENTATION_VERTICAL;
+
+    *minimum = 0;
+    *natural = along_extent ? self->max_extent : 0;
+    *minimum_baseline = -1;
+    *natural_baseline = -1;
+}
+
+static void hyprwave_spectrum_view_size_allocate(GtkWidget *widget, int width, int height,
+                                                 int baseline) {
+    HyprwaveSpectrumView *self = HYPRWAVE_SPECTRUM_VIEW(widget);
+    (void)baseline;
+
+    if (self->n_bars == 0) return;
+
+    // The bar node is one slot thick and max_extent long, anchored where bars grow from
+    int slot_min = 0, extent_min = 0;
+    gtk_widget_measure(self->bar_style,
+                       self->is_vertical ? GTK_ORIENTATION_VERTICAL : GTK_ORIENTATION_HORIZONTAL,
+                       -1, &slot_min, NULL, NULL, NULL);
+    gtk_widget_measure(self->bar_style,
+                       self->is_vertical ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL,
+                       -1, &extent_min, NULL, NULL, NULL);
+
+    int span = self->is_vertical ? height : width;
+    int slot = MAX(slot_min, (span + (int)self->n_bars - 1) / (int)self->n_bars);
+    int extent = MAX(extent_min, self->max_extent);
+    self->node_extent = extent;
+
+    GtkAllocation alloc;
+    if (self->is_vertical) {
+        alloc = (GtkAllocation){ 0, 0, extent, slot };
+    } else {
+        alloc = (GtkAllocation){ 0, height - extent, slot, extent };
+    }
+    gtk_widget_size_allocate(self->bar_style, &alloc, -1);
+}
+
+static void hyprwave_spectrum_view_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    HyprwaveSpectrumView *self = HYPRWAVE_SPECTRUM_VIEW(widget);
+
+    int width = gtk_widget_get_width(widget);
+    int height = gtk_widget_get_height(widget);
+    if (self->n_bars == 0 || width <= 0 || height <= 0) return;
+
+    float slot = (float)(self->is_vertical ? height : width) / self->n_bars;
+    if (self->node_extent <= 0) return;
+
+    for (guint i = 0; i < self->n_bars; i++) {
+        gint extent = self->extents[i];
+        if (extent <= SPECTRUM_VIEW_MIN_EXTENT) continue;
+
+        // Map the full-height node onto this bar: shift into its slot and scale it
+        // along the extent axis about the edge bars grow from. Nothing is clipped,
+        // so the box-shadow glow and all four corners are drawn and the gradient
+        // spans the bar, as with one widget per bar. Radius and glow are scaled
+        // with the bar along that axis.
+        float scale = (float)extent / self->node_extent;
+
+        gtk_snapshot_save(snapshot);
+        if (self->is_vertical) {
+            gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(0, i * slot));
+            gtk_snapshot_scale(snapshot, scale, 1.0f);
+        } else {
+            gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(i * slot, height));
+            gtk_snapshot_scale(snapshot, 1.0f, scale);
+            gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(0, -height));
+        }
+        // Same cached render node for every bar
+        gtk_widget_snapshot_child(widget, self->bar_style, snapshot);
+        gtk_snapshot_restore(snapshot);
+    }
+}
+
+static void hyprwave_spectrum_view_dispose(GObject *object) {
+    HyprwaveSpectrumView *self = HYPRWAVE_SPECTRUM_VIEW(object);
+
+    g_clear_pointer(&self->bar_style, gtk_widget_unparent);
+
+    G_OBJECT_CLASS(hyprwave_spectrum_view_parent_class)->dispose(object);
+}
+
+static void hyprwave_spectrum_view_finalize(GObject *object) {
+    HyprwaveSpectrumView *self = HYPRWAVE_SPECTRUM_VIEW(object);
+
+    g_free(self->extents);
+
+    G_OBJECT_CLASS(hyprwave_spectrum_view_parent_class)->finalize(object);
+}
+
+static void hyprwave_spectrum_view_class_init(HyprwaveSpectrumViewClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+
+    object_class->dispose = hyprwave_spectrum_view_dispose;
+    object_class->finalize = hyprwave_spectrum_view_finalize;
+
+    widget_class->measure = hyprwave_spectrum_view_measure;
+    widget_class->size_allocate = hyprwave_spectrum_view_size_allocate;
+    widget_class->snapshot = hyprwave_spectrum_view_snapshot;
+
+    gtk_widget_class_set_css_name(widget_class, "spectrum-view");
+}
+
+static void hyprwave_spectrum_view_init(HyprwaveSpectrumView *self) {
+    self->bar_style = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+    gtk_widget_add_css_class(self->bar_style, "visualizer-bar");
+    gtk_widget_set_can_target(self->bar_style, FALSE);
+    gtk_widget_set_parent(self->bar_style, GTK_WIDGET(self));
+}
+
+GtkWidget* hyprwave_spectrum_view_new(gboolean is_vertical, guint n_bars, gint max_extent) {
+    HyprwaveSpectrumView *self = g_object_new(HYPRWAVE_TYPE_SPECTRUM_VIEW, NULL);
+
+    self->is_vertical = is_vertical;
+    self->n_bars = n_bars;
+    self->max_extent = MAX(max_extent, SPECTRUM_VIEW_MIN_EXTENT);
+    self->extents = g_new0(gint, n_bars);
+
+    return GTK_WIDGET(self);
+}
+
+gboolean hyprwave_spectrum_view_set_levels(HyprwaveSpectrumView *view, const float *levels) {
+    g_return_val_if_fail(HYPRWAVE_IS_SPECTRUM_VIEW(view), FALSE);
+
+    gboolean changed = FALSE;
+    gboolean visible = FALSE;
+
+    for (guint i = 0; i < view->n_bars; i++) {
+        float level = levels[i] < SPECTRUM_VIEW_LEVEL_FLOOR ? 0.0f : MIN(levels[i], 1.0f);
+        gint extent = SPECTRUM_VIEW_MIN_EXTENT +
+                      (gint)(level * (view->max_extent - SPECTRUM_VIEW_MIN_EXTENT));
+
+        if (extent > SPECTRUM_VIEW_MIN_EXTENT) visible = TRUE;
+
+        if (extent != view->extents[i]) {
+            view->extents[i] = extent;
+            changed = TRUE;
+        }
+    }
+
+    // Only pixels changed: no resize, no restyle
+    if (changed) {
+        gtk_widget_queue_draw(GTK_WIDGET(view));
+    }
+
+    return visible;
+}
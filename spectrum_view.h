@@ -0,0 +1,40 @@
+#ifndef SPECTRUM_VIEW_H
+#define SPECTRUM_VIEW_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Spectrum View
+ *
+ * A single widget that draws every visualizer bar in one snapshot pass.
+ * Level updates only queue a redraw, never a relayout or CSS restyle.
+ *
+ * Theme colors come from one internal ".visualizer-bar" CSS node: it is
+ * styled like the old per-bar boxes, rendered once at full height, and
+ * its cached render node is scaled down to each bar's current height
+ * (background, border and shadow included).
+ */
+
+#define HYPRWAVE_TYPE_SPECTRUM_VIEW (hyprwave_spectrum_view_get_type())
+G_DECLARE_FINAL_TYPE(HyprwaveSpectrumView, hyprwave_spectrum_view, HYPRWAVE, SPECTRUM_VIEW, GtkWidget)
+
+/**
+ * Create a spectrum view.
+ *
+ * @param is_vertical TRUE to stack bars top-to-bottom growing rightwards,
+ *                    FALSE to lay them out left-to-right growing upwards
+ * @param n_bars Number of bars
+ * @param max_extent Length in pixels of a bar at level 1.0
+ * @return A new widget
+ */
+GtkWidget* hyprwave_spectrum_view_new(gboolean is_vertical, guint n_bars, gint max_extent);
+
+/**
+ * Update bar levels and queue a redraw if anything visibly changed.
+ *
+ * @param levels n_bars values in 0.0-1.0; values below 0.01 hide the bar
+ * @return TRUE if at least one bar is visible
+ */
+gboolean hyprwave_spectrum_view_set_levels(HyprwaveSpectrumView *view, const float *levels);
+
+#endif // SPECTRUM_VIEW_H
@@ -0,0 +1,235 @@
+#include "../art_fetch.h"
+#include <libsoup/soup.h>
+#include <string.h>
+
+/**
+ * Album Art Fetcher Tests
+ *
+ * A SoupServer on loopback, run from its own thread, stands in for an
+ * art CDN. Each path triggers one of the fetcher's guards: the size cap
+ * (announced by Content-Length and discovered while streaming a chunked
+ * body), conditional GET revalidation, the read timeout and HTTP errors.
+ */
+
+#define OVERSIZED_BYTES (ART_FETCH_MAX_BYTES + 1024 * 1024)
+#define STREAM_CHUNK 65536
+#define TEST_TIMEOUT_SECONDS 1
+#define TEST_ETAG "\"v1\""
+#define TEST_LAST_MODIFIED "Wed, 01 Jan 2025 00:00:00 GMT"
+#define TEST_BODY "not really a png"
+
+static GMainContext *server_context = NULL;
+static GMainLoop *server_loop = NULL;
+static gchar *base_url = NULL;
+
+// Whole oversized body in one go: the server announces it in Content-Length
+static void handle_large(SoupServer *server, SoupServerMessage *msg, const char *path,
+                         GHashTable *query, gpointer user_data) {
+    soup_server_message_set_status(msg, SOUP_STATUS_OK, NULL);
+    soup_server_message_set_response(msg, "image/png", SOUP_MEMORY_TAKE,
+                                     g_malloc0(OVERSIZED_BYTES), OVERSIZED_BYTES);
+}
+
+// Same size chunked: no Content-Length, so only the read loop can stop it
+static void handle_stream(SoupServer *server, SoupServerMessage *msg, const char *path,
+                          GHashTable *query, gpointer user_data) {
+    static const guint8 zeros[STREAM_CHUNK] = { 0 };
+    SoupMessageHeaders *headers = soup_server_message_get_response_headers(msg);
+    SoupMessageBody *body = soup_server_message_get_response_body(msg);
+
+    soup_server_message_set_status(msg, SOUP_STATUS_OK, NULL);
+    soup_message_headers_set_encoding(headers, SOUP_ENCODING_CHUNKED);
+    soup_message_headers_set_content_type(headers, "image/png", NULL);
+    for (gsize sent = 0; sent < OVERSIZED_BYTES; sent += STREAM_CHUNK) {
+        soup_message_body_append(body, SOUP_MEMORY_STATIC, zeros, STREAM_CHUNK);
+    }
+    soup_message_body_complete(body);
+}
+
+// 304 when either validator matches, otherwise the image with both validators
+static void handle_validated(SoupServer *server, SoupServerMessage *msg, const char *path,
+                             GHashTable *query, gpointer user_data) {
+    SoupMessageHeaders *request = soup_server_message_get_request_headers(msg);
+    SoupMessageHeaders *response = soup_server_message_get_response_headers(msg);
+    const char *if_none_match = soup_message_headers_get_one(request, "If-None-Match");
+    const char *if_modified_since = soup_message_headers_get_one(request, "If-Modified-Since");
+
+    soup_message_headers_replace(response, "ETag", TEST_ETAG);
+    soup_message_headers_replace(response, "Last-Modified", TEST_LAST_MODIFIED);
+
+    if (g_strcmp0(if_none_match, TEST_ETAG) == 0 ||
+        g_strcmp0(if_modified_since, TEST_LAST_MODIFIED) == 0) {
+        soup_server_message_set_status(msg, SOUP_STATUS_NOT_MODIFIED, NULL);
+        return;
+    }
+
+    soup_server_message_set_status(msg, SOUP_STATUS_OK, NULL);
+    soup_server_message_set_response(msg, "image/png", SOUP_MEMORY_STATIC,
+                                     TEST_BODY, strlen(TEST_BODY));
+}
+
+// Never answers: the client's read timeout has to end the request
+static void handle_stall(SoupServer *server, SoupServerMessage *msg, const char *path,
+                         GHashTable *query, gpointer user_data) {
+    soup_server_message_pause(msg);
+}
+
+static void handle_error(SoupServer *server, SoupServerMessage *msg, const char *path,
+                         GHashTable *query, gpointer user_data) {
+    soup_server_message_set_status(msg, SOUP_STATUS_INTERNAL_SERVER_ERROR, NULL);
+}
+
+static gpointer server_thread(gpointer data) {
+    g_main_context_push_thread_default(server_context);
+    g_main_loop_run(server_loop);
+    g_main_context_pop_thread_default(server_context);
+    return NULL;
+}
+
+static SoupServer* start_server(void) {
+    GError *error = NULL;
+
+    // Listening sockets attach to the thread-default context, which the
+    // server thread then runs; the fetches block the test thread
+    server_context = g_main_context_new();
+    server_loop = g_main_loop_new(server_context, FALSE);
+    g_main_context_push_thread_default(server_context);
+
+    SoupServer *server = soup_server_new(NULL, NULL);
+    soup_server_add_handler(server, "/large", handle_large, NULL, NULL);
+    soup_server_add_handler(server, "/stream", handle_stream, NULL, NULL);
+    soup_server_add_handler(server, "/validated", handle_validated, NULL, NULL);
+    soup_server_add_handler(server, "/stall", handle_stall, NULL, NULL);
+    soup_server_add_handler(server, "/error", handle_error, NULL, NULL);
+
+    if (!soup_server_listen_local(server, 0, SOUP_SERVER_LISTEN_IPV4_ONLY, &error)) {
+        g_error("Failed to start test server: %s", error->message);
+    }
+    g_main_context_pop_thread_default(server_context);
+
+    GSList *uris = soup_server_get_uris(server);
+    base_url = g_strdup_printf("http://127.0.0.1:%d", g_uri_get_port(uris->data));
+    g_slist_free_full(uris, (GDestroyNotify)g_uri_unref);
+
+    return server;
+}
+
+static ArtFetchStatus fetch(const gchar *path, const gchar *etag, const gchar *last_modified,
+                            ArtFetchResponse *response, GError **error) {
+    gchar *url = g_strconcat(base_url, path, NULL);
+    ArtFetchStatus status = art_fetch_http(url, etag, last_modified, NULL, response, error);
+    g_free(url);
+    return status;
+}
+
+static void check_content_length_cap(void) {
+    ArtFetchResponse response = { 0 };
+    GError *error = NULL;
+
+    g_assert_cmpint(fetch("/large", NULL, NULL, &response, &error), ==, ART_FETCH_FAILED);
+    g_assert_error(error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE);
+    g_assert_null(response.body);
+    g_clear_error(&error);
+}
+
+static void check_streaming_cap(void) {
+    ArtFetchResponse response = { 0 };
+    GError *error = NULL;
+
+    g_assert_cmpint(fetch("/stream", NULL, NULL, &response, &error), ==, ART_FETCH_FAILED);
+    g_assert_error(error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE);
+    g_assert_null(response.body);
+    g_clear_error(&error);
+}
+
+static void check_revalidation(void) {
+    ArtFetchResponse response = { 0 };
+    GError *error = NULL;
+
+    // First fetch: the body plus the validators to store with it
+    g_assert_cmpint(fetch("/validated", NULL, NULL, &response, &error), ==, ART_FETCH_OK);
+    g_assert_no_error(error);
+    g_assert_nonnull(response.body);
+    g_assert_cmpuint(g_bytes_get_size(response.body), ==, strlen(TEST_BODY));
+    g_assert_cmpstr(response.etag, ==, TEST_ETAG);
+    g_assert_cmpstr(response.last_modified, ==, TEST_LAST_MODIFIED);
+    art_fetch_response_clear(&response);
+
+    // Either validator alone revalidates without a body
+    g_assert_cmpint(fetch("/validated", TEST_ETAG, NULL, &response, &error),
+                    ==, ART_FETCH_NOT_MODIFIED);
+    g_assert_no_error(error);
+    g_assert_null(response.body);
+
+    g_assert_cmpint(fetch("/validated", NULL, TEST_LAST_MODIFIED, &response, &error),
+                    ==, ART_FETCH_NOT_MODIFIED);
+    g_assert_no_error(error);
+    g_assert_null(response.body);
+
+    // A stale validator gets the new image
+    g_assert_cmpint(fetch("/validated", "\"v0\"", NULL, &response, &error), ==, ART_FETCH_OK);
+    g_assert_no_error(error);
+    g_assert_nonnull(response.body);
+    art_fetch_response_clear(&response);
+}
+
+static void check_timeout(void) {
+    ArtFetchResponse response = { 0 };
+    GError *error = NULL;
+    gint64 start = g_get_monotonic_time();
+
+    g_assert_cmpint(fetch("/stall", NULL, NULL, &response, &error), ==, ART_FETCH_FAILED);
+    g_assert_error(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert_null(response.body);
+    g_clear_error(&error);
+
+    // Gave up on the configured timeout, not some other limit
+    gint64 elapsed = g_get_monotonic_time() - start;
+    g_assert_cmpint(elapsed, <, (TEST_TIMEOUT_SECONDS + 4) * G_USEC_PER_SEC);
+}
+
+static void check_http_errors(void) {
+    ArtFetchResponse response = { 0 };
+    GError *error = NULL;
+
+    g_assert_cmpint(fetch("/error", NULL, NULL, &response, &error), ==, ART_FETCH_FAILED);
+    g_assert_error(error, G_IO_ERROR, G_IO_ERROR_FAILED);
+    g_assert_null(response.body);
+    g_clear_error(&error);
+
+    g_assert_cmpint(fetch("/missing", NULL, NULL, &response, &error), ==, ART_FETCH_FAILED);
+    g_assert_error(error, G_IO_ERROR, G_IO_ERROR_FAILED);
+    g_assert_null(response.body);
+    g_clear_error(&error);
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+
+    // Loopback must not be routed through a proxy from the environment
+    g_unsetenv("http_proxy");
+    g_unsetenv("HTTP_PROXY");
+    g_unsetenv("all_proxy");
+    g_unsetenv("ALL_PROXY");
+
+    art_fetch_set_timeout(TEST_TIMEOUT_SECONDS);
+    SoupServer *server = start_server();
+    GThread *thread = g_thread_new("art-fetch-test-server", server_thread, NULL);
+
+    g_test_add_func("/art-fetch/size-cap/content-length", check_content_length_cap);
+    g_test_add_func("/art-fetch/size-cap/streaming", check_streaming_cap);
+    g_test_add_func("/art-fetch/revalidation", check_revalidation);
+    g_test_add_func("/art-fetch/timeout", check_timeout);
+    g_test_add_func("/art-fetch/http-errors", check_http_errors);
+
+    int result = g_test_run();
+
+    g_main_loop_quit(server_loop);
+    g_thread_join(thread);
+    soup_server_disconnect(server);
+    g_object_unref(server);
+    g_main_loop_unref(server_loop);
+    g_main_context_unref(server_context);
+    g_free(base_url);
+    return result;
+}
@@ -0,0 +1,139 @@
+#include "../audio_kernels.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * Audio Kernel Tests
+ *
+ * Each vectorized kernel set against the scalar reference: the mono
+ * downmix and the peak must match exactly, the sum of squares within
+ * float summation-order tolerance. Lengths cover empty input, pure tails
+ * and every remainder around the 4- and 8-wide loops; buffers are also
+ * tested one float off their natural alignment.
+ */
+
+#define MAX_FRAMES 4099
+#define SUM_SQ_TOLERANCE 1e-4  // Relative; reordering a float sum of up to 4k terms
+
+static const gsize lengths[] = {
+    0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 64, 257, 1023, 1024, 4096, MAX_FRAMES
+};
+
+static void fill_random(float *buffer, gsize n, guint32 seed) {
+    GRand *rand = g_rand_new_with_seed(seed);
+    for (gsize i = 0; i < n; i++) {
+        buffer[i] = (float)g_rand_double_range(rand, -1.0, 1.0);
+    }
+    g_rand_free(rand);
+}
+
+static void assert_sum_sq_close(float actual, float expected) {
+    gdouble tolerance = SUM_SQ_TOLERANCE * MAX(1.0, fabs(expected));
+    g_assert_cmpfloat_with_epsilon(actual, expected, tolerance);
+}
+
+static void check_downmix(gconstpointer data) {
+    const gchar *kernels = data;
+    if (!audio_kernels_select(kernels)) {
+        g_test_skip("kernel set not supported on this CPU");
+        return;
+    }
+
+    // One spare float so the misaligned run stays in bounds
+    float *interleaved = g_new(float, 2 * MAX_FRAMES + 1);
+    float *mono = g_new(float, MAX_FRAMES + 1);
+    float *expected = g_new(float, MAX_FRAMES + 1);
+    fill_random(interleaved, 2 * MAX_FRAMES + 1, 0x5eed);
+
+    // Loudest sample negative and near the end: the peak must see |x| and the tail
+    interleaved[2 * MAX_FRAMES - 2] = -1.0f;
+    interleaved[2 * MAX_FRAMES - 1] = -1.0f;
+
+    for (guint misalign = 0; misalign <= 1; misalign++) {
+        for (gsize l = 0; l < G_N_ELEMENTS(lengths); l++) {
+            gsize n = lengths[l];
+            if (2 * n + misalign > 2 * MAX_FRAMES + 1) continue;
+
+            const float *input = interleaved + misalign;
+            AudioStats stats;
+            AudioStats reference;
+
+            audio_downmix_stereo_scalar(input, n, expected + misalign, &reference);
+            audio_downmix_stereo(input, n, mono + misalign, &stats);
+
+            g_assert_true(memcmp(mono + misalign, expected + misalign, n * sizeof(float)) == 0);
+            g_assert_cmpfloat(stats.peak, ==, reference.peak);
+            assert_sum_sq_close(stats.sum_sq, reference.sum_sq);
+        }
+    }
+
+    g_free(expected);
+    g_free(mono);
+    g_free(interleaved);
+}
+
+static void check_analyze(gconstpointer data) {
+    const gchar *kernels = data;
+    if (!audio_kernels_select(kernels)) {
+        g_test_skip("kernel set not supported on this CPU");
+        return;
+    }
+
+    float *samples = g_new(float, MAX_FRAMES + 1);
+    fill_random(samples, MAX_FRAMES + 1, 0xfeed);
+    samples[MAX_FRAMES - 1] = -1.0f;
+
+    for (guint misalign = 0; misalign <= 1; misalign++) {
+        for (gsize l = 0; l < G_N_ELEMENTS(lengths); l++) {
+            gsize n = lengths[l];
+            if (n + misalign > MAX_FRAMES + 1) continue;
+
+            AudioStats stats;
+            AudioStats reference;
+            audio_analyze_mono_scalar(samples + misalign, n, &reference);
+            audio_analyze_mono(samples + misalign, n, &stats);
+
+            g_assert_cmpfloat(stats.peak, ==, reference.peak);
+            assert_sum_sq_close(stats.sum_sq, reference.sum_sq);
+        }
+    }
+
+    g_free(samples);
+}
+
+// The reference itself, against double-precision sums of a known signal
+static void check_scalar_reference(void) {
+    float samples[8] = { 0.5f, -0.25f, 0.75f, -1.0f, 0.0f, 0.125f, -0.5f, 0.25f };
+    AudioStats stats;
+
+    audio_analyze_mono_scalar(samples, G_N_ELEMENTS(samples), &stats);
+    g_assert_cmpfloat(stats.peak, ==, 1.0f);
+    g_assert_cmpfloat_with_epsilon(stats.sum_sq, 2.203125, 1e-6);
+
+    float stereo[4] = { 1.0f, -0.5f, -0.25f, -0.75f };
+    float mono[2];
+    audio_downmix_stereo_scalar(stereo, 2, mono, &stats);
+    g_assert_cmpfloat(mono[0], ==, 0.25f);
+    g_assert_cmpfloat(mono[1], ==, -0.5f);
+    g_assert_cmpfloat(stats.peak, ==, 0.5f);
+    g_assert_cmpfloat_with_epsilon(stats.sum_sq, 0.3125, 1e-6);
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/audio-kernels/scalar-reference", check_scalar_reference);
+
+    const gchar *kernel_sets[] = { "sse2", "avx2" };
+    for (gsize i = 0; i < G_N_ELEMENTS(kernel_sets); i++) {
+        gchar *path = g_strdup_printf("/audio-kernels/%s/downmix-stereo", kernel_sets[i]);
+        g_test_add_data_func(path, kernel_sets[i], check_downmix);
+        g_free(path);
+
+        path = g_strdup_printf("/audio-kernels/%s/analyze-mono", kernel_sets[i]);
+        g_test_add_data_func(path, kernel_sets[i], check_analyze);
+        g_free(path);
+    }
+
+    return g_test_run();
+}
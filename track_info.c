@@ -0,0 +1,85 @@
+#include "track_info.h"
+
+gint64 track_info_variant_to_int64(GVariant *value) {
+    if (!value) return 0;
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT64)) return g_variant_get_int64(value);
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT64)) return (gint64)g_variant_get_uint64(value);
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_INT32)) return g_variant_get_int32(value);
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32)) return g_variant_get_uint32(value);
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_DOUBLE)) return (gint64)g_variant_get_double(value);
+    return 0;
+}
+
+static gchar* variant_to_string(GVariant *value) {
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING) ||
+        g_variant_is_of_type(value, G_VARIANT_TYPE_OBJECT_PATH)) {
+        return g_variant_dup_string(value, NULL);
+    }
+    return NULL;
+}
+
+TrackInfo* track_info_new(GVariant *metadata) {
+    TrackInfo *info = g_new0(TrackInfo, 1);
+
+    if (metadata && g_variant_is_of_type(metadata, G_VARIANT_TYPE_VARDICT)) {
+        GVariantIter iter;
+        const gchar *key;
+        GVariant *value;
+
+        g_variant_iter_init(&iter, metadata);
+        while (g_variant_iter_loop(&iter, "{&sv}", &key, &value)) {
+            if (g_strcmp0(key, "xesam:title") == 0) {
+                g_free(info->title);
+                info->title = variant_to_string(value);
+            } else if (g_strcmp0(key, "xesam:artist") == 0) {
+                if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING_ARRAY)) {
+                    g_strfreev(info->artists);
+                    info->artists = g_variant_dup_strv(value, NULL);
+                }
+            } else if (g_strcmp0(key, "xesam:album") == 0) {
+                g_free(info->album);
+                info->album = variant_to_string(value);
+            } else if (g_strcmp0(key, "mpris:artUrl") == 0) {
+                g_free(info->art_url);
+                info->art_url = variant_to_string(value);
+            } else if (g_strcmp0(key, "xesam:url") == 0) {
+                g_free(info->url);
+                info->url = variant_to_string(value);
+            } else if (g_strcmp0(key, "mpris:trackid") == 0) {
+                g_free(info->track_id);
+                info->track_id = variant_to_string(value);
+            } else if (g_strcmp0(key, "mpris:length") == 0) {
+                info->length = track_info_variant_to_int64(value);
+            } else if (g_strcmp0(key, "xesam:audioCodec") == 0) {
+                g_free(info->codec);
+                info->codec = variant_to_string(value);
+            } else if (g_strcmp0(key, "xesam:audioBitrate") == 0) {
+                gint64 bitrate = track_info_variant_to_int64(value);
+                // Some players report bits per second rather than kbps
+                info->bitrate = (gint)(bitrate >= 10000 ? bitrate / 1000 : bitrate);
+            } else if (g_strcmp0(key, "xesam:audioSampleRate") == 0) {
+                info->sample_rate = (gint)track_info_variant_to_int64(value);
+            }
+        }
+    }
+
+    if (!info->artists) info->artists = g_new0(gchar *, 1);
+    if (info->length < 0) info->length = 0;
+    return info;
+}
+
+void track_info_free(TrackInfo *info) {
+    if (!info) return;
+    g_free(info->track_id);
+    g_free(info->title);
+    g_strfreev(info->artists);
+    g_free(info->album);
+    g_free(info->art_url);
+    g_free(info->url);
+    g_free(info->codec);
+    g_free(info);
+}
+
+const gchar* track_info_get_artist(const TrackInfo *info) {
+    return info && info->artists[0] ? info->artists[0] : NULL;
+}
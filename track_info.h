@@ -0,0 +1,57 @@
+#ifndef TRACK_INFO_H
+#define TRACK_INFO_H
+
+#include <glib.h>
+
+/**
+ * Track Info
+ *
+ * Typed snapshot of an MPRIS Metadata dictionary. It is parsed once when
+ * Metadata changes so that hot paths (seeking, slider motion, position
+ * rendering) read plain fields instead of walking the a{sv} again.
+ *
+ * String fields are NULL when the player does not provide them. Audio
+ * format hints are non-standard xesam keys that only some players set;
+ * they are 0/NULL otherwise.
+ */
+
+typedef struct {
+    gchar *track_id;            // mpris:trackid (object path)
+    gchar *title;               // xesam:title
+    gchar **artists;            // xesam:artist, NULL-terminated (never NULL itself)
+    gchar *album;               // xesam:album
+    gchar *art_url;             // mpris:artUrl
+    gchar *url;                 // xesam:url
+    gint64 length;              // mpris:length in microseconds, 0 if unknown
+
+    // Audio format hints
+    gchar *codec;               // xesam:audioCodec
+    gint bitrate;               // xesam:audioBitrate in kbps
+    gint sample_rate;           // xesam:audioSampleRate in Hz
+} TrackInfo;
+
+/**
+ * Parse a Metadata dictionary.
+ *
+ * @param metadata a{sv} value, or NULL for an empty track
+ * @return A new snapshot, free with track_info_free()
+ */
+TrackInfo* track_info_new(GVariant *metadata);
+
+/**
+ * Free a snapshot (NULL-safe).
+ */
+void track_info_free(TrackInfo *info);
+
+/**
+ * First artist, or NULL.
+ */
+const gchar* track_info_get_artist(const TrackInfo *info);
+
+/**
+ * Read an MPRIS integer (mpris:length, Position, ...). Players send it with
+ * whatever signedness and width they chose; 0 for NULL or non-numeric values.
+ */
+gint64 track_info_variant_to_int64(GVariant *value);
+
+#endif // TRACK_INFO_H
@@ -76,6 +76,22 @@ static gchar* format_vertical_time(gint64 position_us, gint64 length_us) {
                           seconds / 10, seconds % 10);
 }
 
+// Player position now: the owner's extrapolated clock, else the last pushed value
+static gint64 get_current_position(VerticalDisplayState *state) {
+    if (state->position_func) {
+        return state->position_func(state->position_data);
+    }
+    return state->current_position;
+}
+
+static void show_current_time(VerticalDisplayState *state) {
+    gchar *time_text = format_vertical_time(get_current_position(state), state->track_length);
+    if (g_strcmp0(gtk_label_get_text(GTK_LABEL(state->label)), time_text) != 0) {
+        gtk_label_set_text(GTK_LABEL(state->label), time_text);
+    }
+    g_free(time_text);
+}
+
 // Status animation (PAUSED loop)
 static gboolean animate_paused(gpointer user_data) {
     VerticalDisplayState *state = (VerticalDisplayState *)user_data;
@@ -103,9 +119,7 @@ static gboolean show_playing_status(gpointer user_data) {
         state->status_animation_timer = 0;
         
         // Show current time
-        gchar *time_text = format_vertical_time(state->current_position, state->track_length);
-        gtk_label_set_text(GTK_LABEL(state->label), time_text);
-        g_free(time_text);
+        show_current_time(state);
         
         return G_SOURCE_REMOVE;
     }
@@ -173,9 +187,7 @@ static gboolean scroll_animation(gpointer user_data) {
         state->current_mode = DISPLAY_MODE_TIME;
         state->scroll_timer = 0;
         
-        gchar *time_text = format_vertical_time(state->current_position, state->track_length);
-        gtk_label_set_text(GTK_LABEL(state->label), time_text);
-        g_free(time_text);
+        show_current_time(state);
         
         g_strfreev(lines);
         g_free(full_text);
@@ -224,22 +236,43 @@ static gboolean scroll_animation(gpointer user_data) {
 
 
 
+static gboolean update_timer_display(gpointer user_data);
+
+// Milliseconds until the shown second changes (at least 1, so ticks never spin)
+static guint ms_to_next_second(VerticalDisplayState *state) {
+    gint64 position_ms = MAX(get_current_position(state), 0) / 1000;
+    return (guint)(1000 - position_ms % 1000);
+}
+
+// Run the clock only while it can change and be seen: playing and shown
+static void sync_update_timer(VerticalDisplayState *state) {
+    gboolean wanted = state->is_showing && !state->is_paused;
+
+    if (!wanted && state->update_timer > 0) {
+        g_source_remove(state->update_timer);
+        state->update_timer = 0;
+    } else if (wanted && state->update_timer == 0) {
+        if (state->current_mode == DISPLAY_MODE_TIME) {
+            show_current_time(state);
+        }
+        state->update_timer = g_timeout_add(ms_to_next_second(state), update_timer_display, state);
+    }
+}
+
 // Update timer display (only updates when in TIME mode)
+// Re-reads the position each time instead of counting, so it stays right
+// across the status/scroll animations and at any playback rate. Each tick
+// is re-armed for the next whole second, so it wakes once a second.
 static gboolean update_timer_display(gpointer user_data) {
     VerticalDisplayState *state = (VerticalDisplayState *)user_data;
     
     // CRITICAL: Only update if in TIME mode
-    if (state->current_mode != DISPLAY_MODE_TIME) {
-        return G_SOURCE_CONTINUE;
+    if (state->current_mode == DISPLAY_MODE_TIME) {
+        show_current_time(state);
     }
     
-    gchar *time_text = format_vertical_time(state->current_position, state->track_length);
-    gtk_label_set_text(GTK_LABEL(state->label), time_text);
-    g_free(time_text);
-    
-    state->current_position += 1000000;
-    
-    return G_SOURCE_CONTINUE;
+    state->update_timer = g_timeout_add(ms_to_next_second(state), update_timer_display, state);
+    return G_SOURCE_REMOVE;
 }
 
 VerticalDisplayState* vertical_display_init() {
@@ -267,14 +300,14 @@ VerticalDisplayState* vertical_display_init() {
     state->scroll_index = 0;
     state->fade_opacity = 0.0;
     state->current_mode = DISPLAY_MODE_TIME;
-    state->is_paused = FALSE;
+    state->is_paused = TRUE;  // Until the player reports Playing
     state->animation_frame = 0;
     
     state->current_title = g_strdup("NO TRACK");
     state->current_artist = g_strdup("NO ARTIST");
     
-    // Start timer update
-    state->update_timer = g_timeout_add_seconds(1, update_timer_display, state);
+    // The clock timer starts once the display is shown while playing
+    state->update_timer = 0;
     
     return state;
 }
@@ -285,6 +318,7 @@ void vertical_display_show(VerticalDisplayState *state) {
     state->is_showing = TRUE;
     gtk_widget_set_visible(state->container, TRUE);
     gtk_widget_set_opacity(state->container, 1.0);
+    sync_update_timer(state);
 }
 
 void vertical_display_hide(VerticalDisplayState *state) {
@@ -292,6 +326,7 @@ void vertical_display_hide(VerticalDisplayState *state) {
     
     state->is_showing = FALSE;
     gtk_widget_set_opacity(state->container, 0.0);
+    sync_update_timer(state);
 }
 
 void vertical_display_update_track(VerticalDisplayState *state,
@@ -330,6 +365,15 @@ void vertical_display_update_track(VerticalDisplayState *state,
     state->scroll_timer = g_timeout_add(SCROLL_INTERVAL_MS, scroll_animation, state);
 }
 
+void vertical_display_set_position_func(VerticalDisplayState *state,
+                                        VerticalPositionFunc func,
+                                        gpointer user_data) {
+    if (!state) return;
+    
+    state->position_func = func;
+    state->position_data = user_data;
+}
+
 void vertical_display_update_position(VerticalDisplayState *state,
                                       gint64 position,
                                       gint64 length) {
@@ -338,13 +382,14 @@ void vertical_display_update_position(VerticalDisplayState *state,
     state->current_position = position;
     state->track_length = length;
     
-    // Timer display will update automatically if in TIME mode
+    // Timer display picks it up on its next refresh if in TIME mode
 }
 
 void vertical_display_set_paused(VerticalDisplayState *state, gboolean paused) {
     if (!state) return;
     
     state->is_paused = paused;
+    sync_update_timer(state);
     
     // Cancel status animations
     if (state->status_animation_timer > 0) {
@@ -13,6 +13,9 @@ typedef enum {
     DISPLAY_MODE_STATUS_SKIPPING
 } DisplayMode;
 
+// Returns the player position in microseconds
+typedef gint64 (*VerticalPositionFunc)(gpointer user_data);
+
 typedef struct {
     GtkWidget *container;
     GtkWidget *label;
@@ -21,8 +24,10 @@ typedef struct {
     
     gchar *current_title;
     gchar *current_artist;
-    gint64 current_position;
+    gint64 current_position;       // Last pushed position (used without a position func)
     gint64 track_length;
+    VerticalPositionFunc position_func;
+    gpointer position_data;
     
     guint scroll_timer;
     guint update_timer;
@@ -53,6 +58,11 @@ void vertical_display_update_track(VerticalDisplayState *state,
                                    const gchar *title,
                                    const gchar *artist);
 
+// Read the position from the owner's clock on every timer refresh
+void vertical_display_set_position_func(VerticalDisplayState *state,
+                                        VerticalPositionFunc func,
+                                        gpointer user_data);
+
 // Update position (for timer)
 void vertical_display_update_position(VerticalDisplayState *state,
                                       gint64 position,
@@ -1,5 +1,9 @@
 #include "visualizer.h"
 #include "pipewire_volume.h"
+#include "pipewire_service.h"
+#include "spectrum.h"
+#include "audio_kernels.h"
+#include "spectrum_view.h"
 #include <math.h>
 #include <string.h>
 #include <spa/param/props.h>
@@ -10,65 +14,16 @@
 #define AGC_ATTACK 0.9      // Fast attack - quickly respond to louder audio
 #define AGC_DECAY 0.9995    // Very slow decay - maintain level during quiet parts
 #define AGC_MIN_THRESHOLD 0.0001  // Minimum level to avoid amplifying silence
+#define SILENCE_RMS 0.00003       // -90 dBFS: dither / noise floor only
 
-// Cached audio node info for searching when player changes
-typedef struct {
-    guint32 id;
-    guint32 pid;
-    guint32 driver_id;    // Sink node this stream is connected to
-    gchar *name;
-    gchar *app_name;
-} AudioNodeInfo;
-
-static void audio_node_info_free(gpointer data) {
-    AudioNodeInfo *info = (AudioNodeInfo *)data;
-    if (info) {
-        g_free(info->name);
-        g_free(info->app_name);
-        g_free(info);
-    }
-}
-
-// Check if child_pid is a descendant of parent_pid
-static gboolean is_descendant_of(guint32 child_pid, guint32 parent_pid) {
-    if (child_pid == 0 || parent_pid == 0) return FALSE;
-    if (child_pid == parent_pid) return TRUE;
-
-    // Read /proc/<child_pid>/stat to get parent PID
-    gchar *stat_path = g_strdup_printf("/proc/%u/stat", child_pid);
-    gchar *contents = NULL;
-    gsize length;
-
-    if (!g_file_get_contents(stat_path, &contents, &length, NULL)) {
-        g_free(stat_path);
-        return FALSE;
-    }
-    g_free(stat_path);
-
-    // Parse stat file - format: pid (comm) state ppid ...
-    // Find the closing parenthesis of comm, then skip to ppid
-    gchar *close_paren = g_strrstr(contents, ")");
-    if (!close_paren) {
-        g_free(contents);
-        return FALSE;
-    }
-
-    guint32 ppid = 0;
-    if (sscanf(close_paren + 2, "%*c %u", &ppid) != 1) {
-        g_free(contents);
-        return FALSE;
-    }
-    g_free(contents);
-
-    if (ppid == parent_pid) return TRUE;
-    if (ppid <= 1) return FALSE;  // Reached init/systemd
-
-    // Recurse up the tree
-    return is_descendant_of(ppid, parent_pid);
+static void destroy_link_proxy(gpointer data) {
+    pw_proxy_destroy((struct pw_proxy *)data);
 }
 
 // Search cached nodes for matching PID and connect if found
 static void search_cached_nodes_for_target(VisualizerState *state);
+static void link_target_stream(VisualizerState *state);
+static void unlink_target_stream(VisualizerState *state);
 
 /**
  * PipeWire Per-Player Audio Visualizer
@@ -78,67 +33,201 @@ static void search_cached_nodes_for_target(VisualizerState *state);
  * independent of volume level.
  *
  * Architecture:
- * 1. pw_registry monitors for nodes matching the target PID
- * 2. When found, pw_stream connects to capture that node's audio
- * 3. Audio is processed with AGC normalization
- * 4. GTK widgets are updated from the main thread via render timer
+ * 1. The shared PipeWire service (pipewire_service.c) reports nodes and ports;
+ *    we index playback streams and watch for the one matching the target PID
+ * 2. When found, our input ports are linked straight to that stream's output
+ *    ports (or, in sink mode, pw_stream captures the sink's monitor)
+ * 3. Audio is downmixed, run through a windowed FFT, grouped into
+ *    log-spaced bands and normalized with AGC
+ * 4. Bars are handed to the main thread through a lock-free triple buffer,
+ *    so the RT thread never waits on GTK
+ * 5. The bars are redrawn from the widget's frame-clock tick, which is detached
+ *    after a few seconds of silence and re-attached when signal returns
  */
 
 // Forward declarations
 static void on_stream_process(void *userdata);
+static void on_stream_param_changed(void *userdata, uint32_t id, const struct spa_pod *param);
 static void on_stream_state_changed(void *userdata, enum pw_stream_state old,
                                     enum pw_stream_state state, const char *error);
-static void on_registry_global(void *data, uint32_t id, uint32_t permissions,
-                               const char *type, uint32_t version,
-                               const struct spa_dict *props);
-static void on_registry_global_remove(void *data, uint32_t id);
 static void connect_to_target(VisualizerState *state);
 static void disconnect_stream(VisualizerState *state);
+static gboolean create_capture_stream(VisualizerState *state);
+static void destroy_capture_stream(VisualizerState *state);
 
 // PipeWire stream events
 static const struct pw_stream_events stream_events = {
     PW_VERSION_STREAM_EVENTS,
     .state_changed = on_stream_state_changed,
+    .param_changed = on_stream_param_changed,
     .process = on_stream_process,
 };
 
-// PipeWire registry events
-static const struct pw_registry_events registry_events = {
-    PW_VERSION_REGISTRY_EVENTS,
-    .global = on_registry_global,
-    .global_remove = on_registry_global_remove,
-};
-
 // Easing function for smooth transitions
 static gdouble ease_out_sine(gdouble t) {
     return sin(t * M_PI / 6.0);
 }
 
-// Process audio samples with AGC normalization
+// Publish the smoothed bars to the UI (RT thread, never blocks).
+// Triple buffer: write into our private slot, then swap it with the shared slot.
+static void publish_bar_frame(VisualizerState *state) {
+    float *frame = state->bar_frames[state->frame_write];
+    for (int i = 0; i < VISUALIZER_BARS; i++) {
+        frame[i] = (float)state->bar_smoothed[i];
+    }
+
+    gint previous = g_atomic_int_exchange(&state->frame_shared,
+                                          state->frame_write | VISUALIZER_FRAME_FRESH);
+    state->frame_write = previous & VISUALIZER_FRAME_INDEX_MASK;
+}
+
+// Take the newest complete frame if one was published (UI thread, never blocks)
+static const float* acquire_bar_frame(VisualizerState *state) {
+    if (g_atomic_int_get(&state->frame_shared) & VISUALIZER_FRAME_FRESH) {
+        gint previous = g_atomic_int_exchange(&state->frame_shared, state->frame_read);
+        state->frame_read = previous & VISUALIZER_FRAME_INDEX_MASK;
+    }
+    return state->bar_frames[state->frame_read];
+}
+
+static void start_rendering(VisualizerState *state);
+
+// GTK main thread: resume rendering after silence
+static gboolean on_render_wake_idle(gpointer user_data) {
+    start_rendering((VisualizerState *)user_data);
+    return G_SOURCE_REMOVE;
+}
+
+// PipeWire loop thread: hop from the RT thread to GTK without allocating on the RT side
+static int request_render_wake(struct spa_loop *loop, bool async, uint32_t seq,
+                               const void *data, size_t size, void *user_data) {
+    (void)loop; (void)async; (void)seq; (void)data; (void)size;
+    g_idle_add(on_render_wake_idle, user_data);
+    return 0;
+}
+
+// PipeWire loop thread: no-op, used to wait for earlier invokes to run
+static int drain_service_loop(struct spa_loop *loop, bool async, uint32_t seq,
+                              const void *data, size_t size, void *user_data) {
+    (void)loop; (void)async; (void)seq; (void)data; (void)size; (void)user_data;
+    return 0;
+}
+
+// Process audio samples into log-spaced frequency bands with AGC normalization
 // Handles stereo input by averaging channels
 static void process_audio_samples(VisualizerState *state, const float *samples, size_t n_samples) {
-    if (n_samples == 0) return;
-
-    // n_samples is total floats, for stereo that's n_samples/2 frames
-    // We'll process as interleaved stereo and average the channels
-    size_t n_frames = n_samples / 2;  // Stereo frames
-    if (n_frames == 0) n_frames = n_samples;  // Fallback for mono
-
-    // Find peak in this buffer (average of L+R)
-    float buffer_peak = 0.0f;
-    for (size_t i = 0; i < n_samples; i += 2) {
-        float left = fabsf(samples[i]);
-        float right = (i + 1 < n_samples) ? fabsf(samples[i + 1]) : left;
-        float avg = (left + right) * 0.5f;
-        if (avg > buffer_peak) {
-            buffer_peak = avg;
+    if (n_samples == 0 || !state->spectrum) return;
+
+    // Capture target changed: start from a clean slate
+    if (g_atomic_int_compare_and_exchange(&state->reset_pending, 1, 0)) {
+        for (int i = 0; i < VISUALIZER_BARS; i++) {
+            state->bar_smoothed[i] = 0.0;
+        }
+        state->agc_peak = AGC_MIN_THRESHOLD;
+        state->hop_peak = 0.0f;
+        state->hop_sum_sq = 0.0;
+        state->hop_samples = 0;
+        spectrum_reset(state->spectrum);
+    }
+
+    guint channels = state->channels > 0 ? state->channels : 1;
+    size_t n_frames = n_samples / channels;
+
+    // Mono capture (budget mode) needs no downmix: a quantum is one copy into
+    // the FFT history, and the peak/energy pass waits until a hop is complete
+    if (channels == 1) {
+        spectrum_push(state->spectrum, samples, n_frames);
+    }
+
+    // Otherwise downmix to mono in fixed-size chunks and append to the FFT history.
+    // The vectorized kernels also measure peak/energy in the same pass.
+    for (size_t offset = 0; channels > 1 && offset < n_frames; ) {
+        size_t chunk = MIN(n_frames - offset, (size_t)VISUALIZER_MONO_CHUNK);
+        const float *frames = samples + offset * channels;
+        AudioStats stats;
+
+        if (channels == 2) {
+            audio_downmix_stereo(frames, chunk, state->mono_buffer, &stats);
+            spectrum_push(state->spectrum, state->mono_buffer, chunk);
+        } else {
+            for (size_t i = 0; i < chunk; i++) {
+                state->mono_buffer[i] = (frames[i * channels] + frames[i * channels + 1]) * 0.5f;
+            }
+            audio_analyze_mono(state->mono_buffer, chunk, &stats);
+            spectrum_push(state->spectrum, state->mono_buffer, chunk);
+        }
+
+        if (stats.peak > state->hop_peak) state->hop_peak = stats.peak;
+        state->hop_sum_sq += stats.sum_sq;
+        state->hop_samples += chunk;
+        offset += chunk;
+    }
+
+    // Transform at most once per displayed frame so the per-quantum cost stays fixed.
+    // Smoothing is tuned for 60fps; rescale it so bars fall at the same speed on any display.
+    gint fps = CLAMP(g_atomic_int_get(&state->render_fps), VISUALIZER_MIN_FPS, VISUALIZER_MAX_FPS);
+    if (fps != state->smoothing_fps) {
+        state->smoothing = pow(SMOOTHING_FACTOR, (gdouble)VISUALIZER_UPDATE_FPS / fps);
+        state->smoothing_fps = fps;
+    }
+
+    guint hop = state->sample_rate / fps;
+    guint pending = spectrum_pending(state->spectrum);
+    if (pending < hop) return;
+
+    // Mono: measure the hop in one pass over the history (its newest
+    // fft_size samples when the hop is longer than the FFT)
+    if (channels == 1) {
+        const float *runs[2];
+        gsize lengths[2];
+        spectrum_peek_recent(state->spectrum, pending, &runs[0], &lengths[0], &runs[1], &lengths[1]);
+        for (int r = 0; r < 2; r++) {
+            AudioStats stats;
+            audio_analyze_mono(runs[r], lengths[r], &stats);
+            if (stats.peak > state->hop_peak) state->hop_peak = stats.peak;
+            state->hop_sum_sq += stats.sum_sq;
+            state->hop_samples += lengths[r];
+        }
+    }
+
+    // Digital silence (no peak) or only dither/noise floor (no energy):
+    // skip the FFT and let the bars fall
+    gdouble hop_rms = state->hop_samples > 0 ? sqrt(state->hop_sum_sq / state->hop_samples) : 0.0;
+    gboolean silent = state->hop_peak < AGC_MIN_THRESHOLD || hop_rms < SILENCE_RMS;
+    state->hop_sum_sq = 0.0;
+    state->hop_samples = 0;
+
+    if (silent) {
+        state->hop_peak = 0.0f;
+        for (int i = 0; i < VISUALIZER_BARS; i++) {
+            state->bar_smoothed[i] *= state->smoothing;
+        }
+        spectrum_mark_consumed(state->spectrum);
+        publish_bar_frame(state);
+        return;
+    }
+    state->hop_peak = 0.0f;
+
+    // Signal is back: ask the UI to resume its frame-clock ticks (once per sleep)
+    if (g_atomic_int_compare_and_exchange(&state->render_sleeping, 1, 0)) {
+        pw_loop_invoke(pw_service_get_loop(), request_render_wake,
+                       0, NULL, 0, false, state);
+    }
+
+    spectrum_compute(state->spectrum, state->band_values);
+
+    // Find the loudest band in this frame
+    float frame_peak = 0.0f;
+    for (int i = 0; i < VISUALIZER_BARS; i++) {
+        if (state->band_values[i] > frame_peak) {
+            frame_peak = state->band_values[i];
         }
     }
 
     // Update AGC peak with attack/decay
-    if (buffer_peak > state->agc_peak) {
+    if (frame_peak > state->agc_peak) {
         // Attack: quickly rise to new peak
-        state->agc_peak = AGC_ATTACK * state->agc_peak + (1.0 - AGC_ATTACK) * buffer_peak;
+        state->agc_peak = AGC_ATTACK * state->agc_peak + (1.0 - AGC_ATTACK) * frame_peak;
     } else {
         // Decay: slowly fall when audio is quieter
         state->agc_peak = AGC_DECAY * state->agc_peak;
@@ -153,36 +242,17 @@ static void process_audio_samples(VisualizerState *state, const float *samples,
     // Calculate gain factor (normalize to ~1.0 peak)
     gdouble gain = 1.0 / effective_peak;
 
-    // Process into frequency bars (using stereo frames)
-    size_t frames_per_bin = n_frames / VISUALIZER_BARS;
-    if (frames_per_bin == 0) frames_per_bin = 1;
-
     for (int i = 0; i < VISUALIZER_BARS; i++) {
-        gdouble sum = 0.0;
-        size_t start_frame = i * frames_per_bin;
-        size_t end_frame = start_frame + frames_per_bin;
-
-        for (size_t f = start_frame; f < end_frame && f < n_frames; f++) {
-            size_t idx = f * 2;  // Stereo interleaved
-            float left = (idx < n_samples) ? samples[idx] : 0.0f;
-            float right = (idx + 1 < n_samples) ? samples[idx + 1] : left;
-            // Average L+R and apply gain
-            gdouble mono = ((left + right) * 0.5) * gain;
-            sum += mono * mono;
-        }
-
-        gdouble rms = sqrt(sum / frames_per_bin);
-
-        // Scale for visualization (already normalized by AGC, so smaller multiplier)
-        gdouble normalized = rms * 2.5;
+        // Square root compresses the dynamic range so quieter bands stay visible
+        gdouble normalized = sqrt(state->band_values[i] * gain);
         if (normalized > 1.0) normalized = 1.0;
 
         // Smooth the values
-        state->bar_smoothed[i] = (SMOOTHING_FACTOR * state->bar_smoothed[i]) +
-                                 ((1.0 - SMOOTHING_FACTOR) * normalized);
-
-        state->bar_heights[i] = state->bar_smoothed[i];
+        state->bar_smoothed[i] = (state->smoothing * state->bar_smoothed[i]) +
+                                 ((1.0 - state->smoothing) * normalized);
     }
+
+    publish_bar_frame(state);
 }
 
 // PipeWire stream process callback - called when audio data is available
@@ -206,13 +276,62 @@ static void on_stream_process(void *userdata) {
     samples = spa_buf->datas[0].data;
     n_samples = spa_buf->datas[0].chunk->size / sizeof(float);
 
-    g_mutex_lock(&state->data_mutex);
     process_audio_samples(state, samples, n_samples);
-    g_mutex_unlock(&state->data_mutex);
 
     pw_stream_queue_buffer(state->pw_stream, buf);
 }
 
+typedef struct {
+    Spectrum *spectrum;
+    guint rate;
+    guint channels;
+} CaptureFormat;
+
+// Data loop thread: adopt the negotiated format between two process() calls
+static int swap_capture_format(struct spa_loop *loop, bool async, uint32_t seq,
+                               const void *data, size_t size, void *user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    const CaptureFormat *format = (const CaptureFormat *)data;
+    (void)loop; (void)async; (void)seq; (void)size;
+
+    if (format->spectrum) {
+        state->spectrum = format->spectrum;
+        state->sample_rate = format->rate;
+    }
+    state->channels = format->channels;
+    g_atomic_int_set(&state->reset_pending, 1);
+    return 0;
+}
+
+// Negotiated format callback - runs on the PipeWire loop thread, never the RT thread
+static void on_stream_param_changed(void *userdata, uint32_t id, const struct spa_pod *param) {
+    VisualizerState *state = (VisualizerState *)userdata;
+
+    if (param == NULL || id != SPA_PARAM_Format) return;
+
+    struct spa_audio_info_raw info;
+    spa_zero(info);
+    if (spa_format_audio_raw_parse(param, &info) < 0 || info.rate == 0 || info.channels == 0) {
+        return;
+    }
+
+    if (info.rate == state->sample_rate && info.channels == state->channels) return;
+
+    // Band edges depend on the rate, so build new tables here rather than on the RT thread
+    CaptureFormat format = { NULL, info.rate, info.channels };
+    Spectrum *old = NULL;
+    if (info.rate != state->sample_rate) {
+        old = state->spectrum;
+        format.spectrum = spectrum_new(old->fft_size, info.rate, VISUALIZER_BARS);
+    }
+
+    pw_data_loop_invoke(pw_context_get_data_loop(pw_service_get_context()), swap_capture_format,
+                        0, &format, sizeof(format), true, state);
+    spectrum_free(old);
+
+    g_print("Visualizer: Capturing %u Hz, %u channel(s)\n", info.rate, info.channels);
+}
+
 // Stream state change callback
 static void on_stream_state_changed(void *userdata, enum pw_stream_state old,
                                     enum pw_stream_state new_state, const char *error) {
@@ -229,135 +348,307 @@ static void on_stream_state_changed(void *userdata, enum pw_stream_state old,
             break;
         case PW_STREAM_STATE_PAUSED:
             g_print("Visualizer stream paused\n");
+            // Our node (and its ports) exist now
+            link_target_stream(state);
             break;
         default:
             break;
     }
 }
 
-// Registry global callback - called for each PipeWire object
-static void on_registry_global(void *data, uint32_t id, uint32_t permissions,
-                               const char *type, uint32_t version,
-                               const struct spa_dict *props) {
-    VisualizerState *state = (VisualizerState *)data;
+// ========================================
+// NODE INDEX
+// ========================================
 
-    // Only interested in audio stream nodes
-    if (strcmp(type, PW_TYPE_INTERFACE_Node) != 0) {
-        return;
-    }
+// "VLC media player" -> "vlc media player"; caller frees
+// find_target_node() matches the MPRIS name exactly or as a substring of this
+static gchar* node_app_key(const PwServiceNode *node) {
+    return node->app_name ? g_utf8_strdown(node->app_name, -1) : NULL;
+}
 
-    if (!props) return;
+static void index_audio_node(VisualizerState *state, const PwServiceNode *node) {
+    if (node->pid > 0) {
+        g_hash_table_replace(state->nodes_by_pid, GUINT_TO_POINTER(node->pid), (gpointer)node);
+    }
+    gchar *key = node_app_key(node);
+    if (key) {
+        g_hash_table_replace(state->nodes_by_app, key, (gpointer)node);
+    }
+}
 
-    // Check if this is an audio output (playback) stream
-    const char *media_class = spa_dict_lookup(props, PW_KEY_MEDIA_CLASS);
-    if (!media_class) {
-        return;
+static void unindex_audio_node(VisualizerState *state, const PwServiceNode *node) {
+    if (node->pid > 0 && g_hash_table_lookup(state->nodes_by_pid, GUINT_TO_POINTER(node->pid)) == node) {
+        g_hash_table_remove(state->nodes_by_pid, GUINT_TO_POINTER(node->pid));
+    }
+    gchar *key = node_app_key(node);
+    if (key && g_hash_table_lookup(state->nodes_by_app, key) == node) {
+        g_hash_table_remove(state->nodes_by_app, key);
     }
+    g_free(key);
+}
 
-    // We want to capture from "Stream/Output/Audio" nodes (playback streams)
-    if (strstr(media_class, "Stream/Output/Audio") == NULL) {
-        return;  // Silently skip non-audio nodes
+// Best match for the current target: serial, then PID, then MPRIS app name
+static const PwServiceNode* find_target_node(VisualizerState *state) {
+    const PwServiceNode *node = NULL;
+
+    if (state->target_serial > 0) {
+        node = pw_service_find_stream_by_serial(state->target_serial);
     }
+    if (!node && state->target_pid > 0) {
+        node = g_hash_table_lookup(state->nodes_by_pid, GUINT_TO_POINTER(state->target_pid));
+    }
+    if (!node && state->target_bus_name) {
+        // "org.mpris.MediaPlayer2.vlc.instance123" -> "vlc"
+        const gchar *prefix = "org.mpris.MediaPlayer2.";
+        const gchar *name = g_str_has_prefix(state->target_bus_name, prefix) ?
+                            state->target_bus_name + strlen(prefix) : state->target_bus_name;
+        gchar *key = g_utf8_strdown(name, -1);
+        gchar *dot = strchr(key, '.');
+        if (dot) *dot = '\0';
+        node = g_hash_table_lookup(state->nodes_by_app, key);
+
+        // Application names are usually longer ("vlc media player"): fall back
+        // to a substring match over the index, as the pactl lookup did
+        if (!node && key[0] != '\0') {
+            GHashTableIter iter;
+            gpointer app_key;
+            gpointer value;
+            g_hash_table_iter_init(&iter, state->nodes_by_app);
+            while (g_hash_table_iter_next(&iter, &app_key, &value)) {
+                if (strstr((const gchar *)app_key, key)) {
+                    node = value;
+                    break;
+                }
+            }
+        }
+        g_free(key);
+    }
+
+    return node;
+}
 
-    // Get object.serial - this corresponds to pactl sink-input index
-    const char *serial_str = spa_dict_lookup(props, PW_KEY_OBJECT_SERIAL);
-    if (!serial_str) {
-        return;  // No serial, can't match
+// Make this stream the capture target and connect to it
+static void attach_to_target_node(VisualizerState *state, const PwServiceNode *node) {
+    gboolean on_sink = node->driver_id > 0 && pw_service_is_sink(node->driver_id);
+
+    // Store target info — the stream node for per-stream capture, otherwise its sink
+    state->target_stream_id = node->id;
+    if (on_sink) {
+        state->target_sink_id = (gint)node->driver_id;
     }
+    state->target_node_id = (!state->capture_stream_only && on_sink) ? node->driver_id : node->id;
+    g_free(state->target_node_name);
+    state->target_node_name = g_strdup(node->app_name ? node->app_name : node->name);
+    state->target_found = TRUE;
+
+    // Connect to the player's stream (or its sink's monitor)
+    connect_to_target(state);
+}
+
+// ========================================
+// SERVICE EVENTS (PipeWire service thread, loop locked)
+// ========================================
 
-    gint node_serial = atoi(serial_str);
-    const char *node_name = spa_dict_lookup(props, PW_KEY_NODE_NAME);
-    const char *app_name = spa_dict_lookup(props, PW_KEY_APP_NAME);
+static void on_service_node_added(const PwServiceNode *node, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    // Only playback streams are capture candidates; sinks are looked up in the model
+    if (node->kind != PW_SERVICE_NODE_STREAM) return;
 
     // Log audio nodes only when we have a target
-    if (state->target_serial > 0) {
-        g_print("Audio node: id=%u serial=%d app='%s'\n",
-                id, node_serial, app_name ? app_name : "?");
+    if (state->target_pid > 0 || state->target_serial > 0) {
+        g_print("Audio node: id=%u serial=%d pid=%u app='%s'\n",
+                node->id, node->serial, node->pid, node->app_name ? node->app_name : "?");
     }
 
-    // Cache this audio node for later searching
-    const char *cache_driver_str = spa_dict_lookup(props, PW_KEY_NODE_DRIVER_ID);
-    if (state->audio_nodes) {
-        AudioNodeInfo *info = g_new0(AudioNodeInfo, 1);
-        info->id = id;
-        info->pid = (guint32)node_serial;  // Store serial in pid field for cache
-        info->driver_id = cache_driver_str ? (guint32)atoi(cache_driver_str) : 0;
-        info->name = g_strdup(node_name);
-        info->app_name = g_strdup(app_name);
-        g_hash_table_insert(state->audio_nodes, GUINT_TO_POINTER(id), info);
+    index_audio_node(state, node);
+
+    if (!state->target_found && find_target_node(state) == node) {
+        g_print("✓ Found target audio node: id=%u serial=%d app='%s' sink=%u\n",
+                node->id, node->serial, node->app_name ? node->app_name : "?", node->driver_id);
+        attach_to_target_node(state, node);
     }
+}
 
-    // Check if this matches our target serial (sink-input index)
-    if (state->target_serial <= 0) {
+// Follow the target stream when it moves to another sink
+static void on_service_node_changed(const PwServiceNode *node, guint changes, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    if (!(changes & PW_SERVICE_CHANGE_DRIVER)) return;
+
+    // Paused streams may hop to a dummy driver; only real sinks are worth following
+    if (node->id != state->target_stream_id ||
+        !pw_service_is_sink(node->driver_id) ||
+        (gint)node->driver_id == state->target_sink_id) {
         return;
     }
-    if (node_serial != state->target_serial) {
-        return;
+
+    g_print("Visualizer: '%s' moved to sink %u\n",
+            node->app_name ? node->app_name : "?", node->driver_id);
+    state->target_sink_id = (gint)node->driver_id;
+
+    // Per-stream links follow the stream by themselves; the monitor does not
+    if (!state->capture_stream_only) {
+        state->target_node_id = node->driver_id;
+        connect_to_target(state);
     }
+}
 
-    // Get the sink this stream is connected to (node.driver-id)
-    const char *driver_str = spa_dict_lookup(props, PW_KEY_NODE_DRIVER_ID);
-    uint32_t sink_id = driver_str ? (uint32_t)atoi(driver_str) : 0;
+static void on_service_node_removed(const PwServiceNode *node, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
 
-    g_print("✓ Found target audio node: id=%u serial=%d app='%s' sink=%u\n",
-            id, node_serial, app_name ? app_name : "?", sink_id);
+    if (node->kind == PW_SERVICE_NODE_STREAM) {
+        unindex_audio_node(state, node);
+    }
 
-    // Store target info — use the sink ID for capture (not the stream node)
-    state->target_node_id = sink_id > 0 ? sink_id : id;
-    g_free(state->target_node_name);
-    state->target_node_name = g_strdup(app_name ? app_name : node_name);
-    state->target_found = TRUE;
+    if (node->id == state->target_node_id || node->id == state->target_stream_id) {
+        g_print("Target node %u removed, disconnecting visualizer\n", node->id);
+        disconnect_stream(state);
+        state->target_node_id = 0;
+        state->target_stream_id = 0;
+        state->target_found = FALSE;
+    }
+}
 
-    // Connect to the sink's monitor to capture this player's audio
-    connect_to_target(state);
+// Link as soon as both ends of a per-stream capture exist
+static void on_service_port_added(const PwServicePort *port, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    if (port->is_monitor) return;
+    link_target_stream(state);
 }
 
-// Search cached nodes for matching serial and connect if found
-static void search_cached_nodes_for_target(VisualizerState *state) {
-    if (!state->audio_nodes || state->target_serial <= 0) return;
+static void on_service_port_removed(const PwServicePort *port, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    // One of our input ports went away (renegotiation): its links died with it
+    if (!port->is_output && state->pw_stream &&
+        port->node_id == pw_stream_get_node_id(state->pw_stream)) {
+        unlink_target_stream(state);
+    }
+    g_hash_table_remove(state->linked_ports, GUINT_TO_POINTER(port->id));
+}
+
+// PipeWire went away: the stream and the model pointers die with the old core
+static void on_service_connection_lost(gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    destroy_capture_stream(state);
+
+    // Serials and node IDs restart with the server; only PID and app name carry over
+    state->target_serial = 0;
+    state->target_sink_id = 0;
+
+    g_atomic_int_set(&state->reset_pending, 1);
+    g_atomic_int_set(&state->clear_pending, 1);
+    g_print("Visualizer: PipeWire connection lost, waiting for reconnect\n");
+}
+
+// New core: recreate the stream; the graph replay then finds the target again
+static void on_service_reconnected(gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    create_capture_stream(state);
+}
+
+static const PwServiceEvents service_events = {
+    .node_added = on_service_node_added,
+    .node_changed = on_service_node_changed,
+    .node_removed = on_service_node_removed,
+    .port_added = on_service_port_added,
+    .port_removed = on_service_port_removed,
+    .connection_lost = on_service_connection_lost,
+    .reconnected = on_service_reconnected,
+};
+
+// Drop our links to the player's stream (server side goes away with the proxies)
+static void unlink_target_stream(VisualizerState *state) {
+    if (state->capture_links) {
+        g_ptr_array_set_size(state->capture_links, 0);
+    }
+    if (state->linked_ports) {
+        g_hash_table_remove_all(state->linked_ports);
+    }
+}
+
+// Link every output port of the player's stream to our input ports.
+// Called whenever a relevant port appears, so it tolerates ports arriving one by one.
+static void link_target_stream(VisualizerState *state) {
+    if (!state->capture_stream_only || !state->pw_stream || state->target_stream_id == 0) {
+        return;
+    }
+
+    guint32 own_node = pw_stream_get_node_id(state->pw_stream);
+    if (own_node == SPA_ID_INVALID) return;
+
+    GPtrArray *inputs = g_ptr_array_new();
+    GPtrArray *outputs = g_ptr_array_new();
 
     GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, state->audio_nodes);
-
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        AudioNodeInfo *info = (AudioNodeInfo *)value;
-        // info->pid is actually the serial number (we stored it there)
-        if ((gint)info->pid == state->target_serial) {
-            uint32_t sink_id = info->driver_id > 0 ? info->driver_id : info->id;
-            g_print("Found cached audio node for serial %d: id=%u sink=%u app='%s'\n",
-                    state->target_serial, info->id, sink_id,
-                    info->app_name ? info->app_name : "?");
-
-            state->target_node_id = sink_id;
-            g_free(state->target_node_name);
-            state->target_node_name = g_strdup(info->app_name ? info->app_name : info->name);
-            state->target_found = TRUE;
-
-            connect_to_target(state);
-            return;
+    gpointer value;
+    g_hash_table_iter_init(&iter, pw_service_get_ports());
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        PwServicePort *port = (PwServicePort *)value;
+        if (port->is_monitor) continue;
+        if (port->node_id == own_node && !port->is_output) {
+            g_ptr_array_add(inputs, port);
+        } else if (port->node_id == state->target_stream_id && port->is_output) {
+            g_ptr_array_add(outputs, port);
         }
     }
 
-    g_print("No cached audio node found for serial %d (will connect when node appears)\n",
-            state->target_serial);
+    for (guint i = 0; i < outputs->len && inputs->len > 0; i++) {
+        PwServicePort *out = g_ptr_array_index(outputs, i);
+        if (g_hash_table_contains(state->linked_ports, GUINT_TO_POINTER(out->id))) continue;
+
+        // Same channel if we have it; a single (mono) input port mixes all channels
+        PwServicePort *in = g_ptr_array_index(inputs, i % inputs->len);
+        for (guint j = 0; j < inputs->len && inputs->len > 1; j++) {
+            PwServicePort *candidate = g_ptr_array_index(inputs, j);
+            if (g_strcmp0(candidate->channel, out->channel) == 0) {
+                in = candidate;
+                break;
+            }
+        }
+
+        struct pw_properties *props = pw_properties_new(
+            PW_KEY_LINK_PASSIVE, "true",
+            NULL);
+        pw_properties_setf(props, PW_KEY_LINK_OUTPUT_NODE, "%u", out->node_id);
+        pw_properties_setf(props, PW_KEY_LINK_OUTPUT_PORT, "%u", out->id);
+        pw_properties_setf(props, PW_KEY_LINK_INPUT_NODE, "%u", own_node);
+        pw_properties_setf(props, PW_KEY_LINK_INPUT_PORT, "%u", in->id);
+
+        struct pw_proxy *link = pw_core_create_object(pw_service_get_core(), "link-factory",
+                                                      PW_TYPE_INTERFACE_Link, PW_VERSION_LINK,
+                                                      &props->dict, 0);
+        pw_properties_free(props);
+
+        if (link) {
+            g_ptr_array_add(state->capture_links, link);
+            g_hash_table_add(state->linked_ports, GUINT_TO_POINTER(out->id));
+            g_print("Visualizer: Linked stream port %u (%s) -> %u\n",
+                    out->id, out->channel ? out->channel : "?", in->id);
+        }
+    }
+
+    g_ptr_array_free(inputs, TRUE);
+    g_ptr_array_free(outputs, TRUE);
 }
 
-// Registry global remove callback
-static void on_registry_global_remove(void *data, uint32_t id) {
-    VisualizerState *state = (VisualizerState *)data;
+// Search the service model for the target and connect if found
+static void search_cached_nodes_for_target(VisualizerState *state) {
+    if (!state->service_listener) return;
 
-    // Remove from cache
-    if (state->audio_nodes) {
-        g_hash_table_remove(state->audio_nodes, GUINT_TO_POINTER(id));
+    const PwServiceNode *node = find_target_node(state);
+    if (!node) {
+        g_print("No cached audio node found for serial %d / PID %u (will connect when node appears)\n",
+                state->target_serial, state->target_pid);
+        return;
     }
 
-    if (id == state->target_node_id) {
-        g_print("Target node %u removed, disconnecting visualizer\n", id);
-        disconnect_stream(state);
-        state->target_node_id = 0;
-        state->target_found = FALSE;
-    }
+    g_print("Found cached audio node for serial %d: id=%u sink=%u app='%s'\n",
+            node->serial, node->id, node->driver_id,
+            node->app_name ? node->app_name : "?");
+    attach_to_target_node(state, node);
 }
 
 // Connect pw_stream to capture audio from a specific player's node
@@ -365,9 +656,15 @@ static void on_registry_global_remove(void *data, uint32_t id) {
 static void connect_to_target(VisualizerState *state) {
     if (!state->pw_stream) return;
 
-    // Need either a known sink or a matched target node
+    // Per-stream capture: no target for the session manager, we link the ports ourselves
     uint32_t capture_node = 0;
-    if (state->target_sink_id > 0) {
+    if (state->capture_stream_only) {
+        if (!state->target_found || state->target_stream_id == 0) {
+            g_print("Visualizer: No target stream found, skipping connection\n");
+            return;
+        }
+        capture_node = PW_ID_ANY;
+    } else if (state->target_sink_id > 0) {
         capture_node = (uint32_t)state->target_sink_id;
     } else if (state->target_found && state->target_node_id > 0) {
         capture_node = state->target_node_id;
@@ -377,91 +674,194 @@ static void connect_to_target(VisualizerState *state) {
     }
 
     // Disconnect existing connection first
+    unlink_target_stream(state);
     pw_stream_disconnect(state->pw_stream);
 
     // Build stream parameters for audio capture
     uint8_t buffer[1024];
     struct spa_pod_builder b = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
 
-    // Request float audio, stereo, 48kHz
+    // Request float audio. The rate is left open unless configured, so the sink's
+    // native rate is used and nothing is resampled; budget mode also downmixes to mono.
+    struct spa_audio_info_raw info = SPA_AUDIO_INFO_RAW_INIT(.format = SPA_AUDIO_FORMAT_F32);
+    if (state->capture_budget) {
+        info.channels = 1;
+        info.position[0] = SPA_AUDIO_CHANNEL_MONO;
+    } else {
+        info.channels = 2;
+        info.position[0] = SPA_AUDIO_CHANNEL_FL;
+        info.position[1] = SPA_AUDIO_CHANNEL_FR;
+    }
+    info.rate = state->capture_rate;
+
     const struct spa_pod *params[1];
-    params[0] = spa_format_audio_raw_build(&b, SPA_PARAM_EnumFormat,
-            &SPA_AUDIO_INFO_RAW_INIT(
-                .format = SPA_AUDIO_FORMAT_F32,
-                .channels = 2,
-                .rate = 48000));
+    params[0] = spa_format_audio_raw_build(&b, SPA_PARAM_EnumFormat, &info);
 
-    g_print("Visualizer: Connecting to sink node %u for '%s' (AGC-normalized)\n",
-            capture_node, state->target_node_name ? state->target_node_name : "?");
+    if (state->capture_stream_only) {
+        g_print("Visualizer: Connecting to stream node %u for '%s' (AGC-normalized)\n",
+                state->target_stream_id, state->target_node_name ? state->target_node_name : "?");
+    } else {
+        g_print("Visualizer: Connecting to sink node %u for '%s' (AGC-normalized)\n",
+                capture_node, state->target_node_name ? state->target_node_name : "?");
+    }
 
-    // Capture from the sink's monitor (not a source)
+    // Capture from the sink's monitor (not a source), or stay unlinked for per-stream capture
     pw_stream_update_properties(state->pw_stream,
         &SPA_DICT_INIT_ARRAY(((struct spa_dict_item[]) {
-            { PW_KEY_STREAM_CAPTURE_SINK, "true" },
+            { PW_KEY_STREAM_CAPTURE_SINK, state->capture_stream_only ? "false" : "true" },
+            { PW_KEY_NODE_AUTOCONNECT, state->capture_stream_only ? "false" : "true" },
             { PW_KEY_NODE_NAME, "hyprwave-visualizer" },
         })));
 
+    // No node.latency hint: a passive follower still runs at the graph's
+    // quantum, and anything smaller than the player's would shrink it for
+    // everyone. Budget mode saves its work in process() instead.
+
+    // Start inactive while the player is paused so we never wake the graph ourselves
+    enum pw_stream_flags flags = PW_STREAM_FLAG_RT_PROCESS |
+                                 PW_STREAM_FLAG_MAP_BUFFERS;
+    if (!state->capture_stream_only) {
+        flags |= PW_STREAM_FLAG_AUTOCONNECT;
+    }
+    if (!state->player_playing) {
+        flags |= PW_STREAM_FLAG_INACTIVE;
+    }
+
     pw_stream_connect(state->pw_stream,
                       PW_DIRECTION_INPUT,
                       capture_node,
-                      PW_STREAM_FLAG_AUTOCONNECT |
-                      PW_STREAM_FLAG_RT_PROCESS |
-                      PW_STREAM_FLAG_MAP_BUFFERS,
+                      flags,
                       params, 1);
 }
 
+// Create the capture stream on the shared core (loop locked). It is a passive
+// monitor: our links never keep the sink (or the graph driver) running, so the
+// sink still suspends when the player stops. It also never follows the default
+// sink on its own; retargeting is ours to do.
+static gboolean create_capture_stream(VisualizerState *state) {
+    state->pw_stream = pw_stream_new(pw_service_get_core(), "HyprWave Visualizer",
+        pw_properties_new(
+            PW_KEY_MEDIA_TYPE, "Audio",
+            PW_KEY_MEDIA_CATEGORY, "Capture",
+            PW_KEY_MEDIA_ROLE, "DSP",
+            PW_KEY_NODE_PASSIVE, "true",
+            PW_KEY_NODE_DONT_RECONNECT, "true",
+            "node.dont-fallback", "true",
+            NULL));
+
+    if (!state->pw_stream) {
+        g_printerr("Failed to create PipeWire stream\n");
+        return FALSE;
+    }
+
+    spa_zero(state->stream_listener);
+    pw_stream_add_listener(state->pw_stream, &state->stream_listener,
+                           &stream_events, state);
+    return TRUE;
+}
+
+// Destroy the capture stream and forget everything pointing into the model (loop locked)
+static void destroy_capture_stream(VisualizerState *state) {
+    unlink_target_stream(state);
+
+    if (state->pw_stream) {
+        pw_stream_destroy(state->pw_stream);
+        state->pw_stream = NULL;
+    }
+
+    // The indexes point into the service model; the next replay rebuilds them
+    g_hash_table_remove_all(state->nodes_by_pid);
+    g_hash_table_remove_all(state->nodes_by_app);
+    state->target_found = FALSE;
+    state->target_node_id = 0;
+    state->target_stream_id = 0;
+}
+
 // Disconnect stream
 static void disconnect_stream(VisualizerState *state) {
+    unlink_target_stream(state);
+
     if (state->pw_stream) {
         pw_stream_disconnect(state->pw_stream);
     }
 
-    // Clear visualization
-    g_mutex_lock(&state->data_mutex);
-    for (int i = 0; i < VISUALIZER_BARS; i++) {
-        state->bar_heights[i] = 0.0;
-        state->bar_smoothed[i] = 0.0;
-    }
-    state->agc_peak = AGC_MIN_THRESHOLD;
-    g_mutex_unlock(&state->data_mutex);
+    // Clear visualization: the RT side resets on its next buffer, the UI on its next frame.
+    // Only flags are touched here, since this may run on the PipeWire thread.
+    g_atomic_int_set(&state->reset_pending, 1);
+    g_atomic_int_set(&state->clear_pending, 1);
 }
 
-// Update visualizer bars (~60fps) - called from GTK main thread
-static gboolean update_visualizer(gpointer user_data) {
-    VisualizerState *state = (VisualizerState *)user_data;
+// Refresh rate of the monitor showing the widget, so RT hops match display frames
+static gint detect_refresh_rate(GtkWidget *widget) {
+    GtkNative *native = gtk_widget_get_native(widget);
+    GdkSurface *surface = native ? gtk_native_get_surface(native) : NULL;
+    if (!surface) return VISUALIZER_UPDATE_FPS;
 
-    if (!state->is_showing) {
-        return G_SOURCE_CONTINUE;
-    }
+    GdkMonitor *monitor = gdk_display_get_monitor_at_surface(gtk_widget_get_display(widget), surface);
+    gint millihertz = monitor ? gdk_monitor_get_refresh_rate(monitor) : 0;
+    if (millihertz <= 0) return VISUALIZER_UPDATE_FPS;
 
-    g_mutex_lock(&state->data_mutex);
+    return CLAMP((millihertz + 500) / 1000, VISUALIZER_MIN_FPS, VISUALIZER_MAX_FPS);
+}
 
-    for (int i = 0; i < VISUALIZER_BARS; i++) {
-        gint min_size = 1;
-        gint max_size = state->is_vertical ? 50 : 24;
+// Hidden or unmapped: park without RT wake-ups, show/map restarts rendering
+static void stop_rendering(VisualizerState *state) {
+    if (state->tick_id > 0) {
+        gtk_widget_remove_tick_callback(state->view, state->tick_id);
+        state->tick_id = 0;
+    }
+    g_atomic_int_set(&state->render_sleeping, 0);
+}
 
-        // Decay to minimum if no audio
-        if (state->bar_heights[i] < 0.01) {
-            state->bar_heights[i] = 0.0;
-        }
+// Update visualizer bars once per display frame - called from GTK main thread
+static gboolean on_render_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    (void)widget;
 
-        // Calculate bar size
-        gint bar_size = min_size + (gint)(state->bar_heights[i] * (max_size - min_size));
+    // Drop whatever was captured before a disconnect
+    if (g_atomic_int_compare_and_exchange(&state->clear_pending, 1, 0)) {
+        acquire_bar_frame(state);
+        memset(state->bar_frames[state->frame_read], 0, sizeof(state->bar_frames[0]));
+    }
 
-        // Update size based on orientation
-        if (state->is_vertical) {
-            gtk_widget_set_size_request(state->bars[i], bar_size, 3);
-        } else {
-            gtk_widget_set_size_request(state->bars[i], 3, bar_size);
-        }
+    // One redraw of a single widget, only if a bar moved by at least a pixel
+    gboolean has_signal = hyprwave_spectrum_view_set_levels(HYPRWAVE_SPECTRUM_VIEW(state->view),
+                                                            acquire_bar_frame(state));
+
+    // After a stretch of silence (or no frames at all), stop ticking entirely
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    if (has_signal || state->last_signal_time == 0) {
+        state->last_signal_time = now;
+    } else if (now - state->last_signal_time > VISUALIZER_SILENCE_TIMEOUT * G_USEC_PER_SEC) {
+        // From now on the first non-silent hop on the RT thread wakes us up
+        state->tick_id = 0;
+        g_atomic_int_set(&state->render_sleeping, 1);
+        return G_SOURCE_REMOVE;
+    }
+
+    return G_SOURCE_CONTINUE;
+}
 
-        gtk_widget_set_visible(state->bars[i], TRUE);
-        gtk_widget_set_opacity(state->bars[i], bar_size <= min_size ? 0.0 : 1.0);
+// Attach the frame-clock tick if the bars are on screen
+static void start_rendering(VisualizerState *state) {
+    if (state->tick_id > 0 || !state->is_showing || !gtk_widget_get_mapped(state->view)) {
+        return;
     }
 
-    g_mutex_unlock(&state->data_mutex);
+    g_atomic_int_set(&state->render_sleeping, 0);
+    g_atomic_int_set(&state->render_fps, detect_refresh_rate(state->view));
+    state->last_signal_time = 0;
+    state->tick_id = gtk_widget_add_tick_callback(state->view, on_render_tick, state, NULL);
+}
 
-    return G_SOURCE_CONTINUE;
+static void on_view_map(GtkWidget *widget, gpointer user_data) {
+    (void)widget;
+    start_rendering((VisualizerState *)user_data);
+}
+
+static void on_view_unmap(GtkWidget *widget, gpointer user_data) {
+    (void)widget;
+    stop_rendering((VisualizerState *)user_data);
 }
 
 // Fade animation (for smooth show/hide)
@@ -494,10 +894,7 @@ static gboolean fade_visualizer(gpointer user_data) {
 }
 
 // Initialize visualizer
-VisualizerState* visualizer_init(gboolean is_vertical) {
-    // Initialize PipeWire library
-    pw_init(NULL, NULL);
-
+VisualizerState* visualizer_init(gboolean is_vertical, gint fft_size) {
     VisualizerState *state = g_new0(VisualizerState, 1);
     state->is_showing = FALSE;
     state->is_running = FALSE;
@@ -509,16 +906,33 @@ VisualizerState* visualizer_init(gboolean is_vertical) {
     state->target_node_name = NULL;
     state->target_found = FALSE;
     state->agc_peak = AGC_MIN_THRESHOLD;
-
-    g_mutex_init(&state->data_mutex);
-
-    // Create node cache for searching when player changes
-    state->audio_nodes = g_hash_table_new_full(g_direct_hash, g_direct_equal,
-                                                NULL, audio_node_info_free);
+    state->sample_rate = VISUALIZER_SAMPLE_RATE;
+    state->channels = 2;
+    state->capture_budget = TRUE;
+    state->capture_rate = 0;
+    state->player_playing = TRUE;
+
+    // Spectrum analyzer tables and SIMD kernels are set up once here, never on the RT thread
+    audio_kernels_init();
+    state->spectrum = spectrum_new(spectrum_normalize_fft_size(fft_size),
+                                   state->sample_rate, VISUALIZER_BARS);
+
+    // Triple buffer slots: RT writes 0, shared holds 1, UI reads 2
+    state->frame_write = 0;
+    state->frame_shared = 1;
+    state->frame_read = 2;
+
+    // Stream indexes for matching the player (filled from the PipeWire service)
+    state->nodes_by_pid = g_hash_table_new(g_direct_hash, g_direct_equal);
+    state->nodes_by_app = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    // Our own links for per-stream capture
+    state->linked_ports = g_hash_table_new(g_direct_hash, g_direct_equal);
+    state->capture_links = g_ptr_array_new_with_free_func(destroy_link_proxy);
+    state->capture_stream_only = TRUE;
 
     // Zero out audio data
     for (int i = 0; i < VISUALIZER_BARS; i++) {
-        state->bar_heights[i] = 0.0;
         state->bar_smoothed[i] = 0.0;
     }
 
@@ -543,51 +957,23 @@ VisualizerState* visualizer_init(gboolean is_vertical) {
     gtk_widget_set_vexpand(container, FALSE);
     gtk_widget_add_css_class(container, "visualizer-container");
 
-    g_print("✓ Visualizer container: %s layout (PipeWire per-player capture)\n",
-            is_vertical ? "vertical" : "horizontal");
+    g_print("✓ Visualizer container: %s layout (PipeWire per-player capture, %u-point FFT, %s kernels)\n",
+            is_vertical ? "vertical" : "horizontal", state->spectrum->fft_size, audio_kernels_name());
 
-    // Create bars
-    for (int i = 0; i < VISUALIZER_BARS; i++) {
-        GtkOrientation bar_orient = is_vertical ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL;
-        GtkWidget *bar = gtk_box_new(bar_orient, 0);
-        state->bars[i] = bar;
-
-        gtk_widget_add_css_class(bar, "visualizer-bar");
-        gtk_widget_set_visible(bar, TRUE);
-
-        if (is_vertical) {
-            gtk_widget_set_size_request(bar, 3, -1);
-            gtk_widget_set_halign(bar, GTK_ALIGN_START);
-            gtk_widget_set_vexpand(bar, TRUE);
-            gtk_widget_set_valign(bar, GTK_ALIGN_FILL);
-        } else {
-            gtk_widget_set_size_request(bar, -1, 3);
-            gtk_widget_set_valign(bar, GTK_ALIGN_END);
-            gtk_widget_set_hexpand(bar, TRUE);
-            gtk_widget_set_halign(bar, GTK_ALIGN_FILL);
-        }
+    // All bars are drawn by one widget in a single snapshot pass
+    state->view = hyprwave_spectrum_view_new(is_vertical, VISUALIZER_BARS, is_vertical ? 50 : 24);
+    gtk_widget_set_hexpand(state->view, TRUE);
+    gtk_widget_set_vexpand(state->view, TRUE);
+    gtk_box_append(GTK_BOX(container), state->view);
 
-        gtk_box_append(GTK_BOX(container), bar);
-    }
+    // Render only while mapped; the tick callback follows the monitor's refresh rate
+    state->render_sleeping = 0;
+    state->render_fps = VISUALIZER_UPDATE_FPS;
+    g_signal_connect(state->view, "map", G_CALLBACK(on_view_map), state);
+    g_signal_connect(state->view, "unmap", G_CALLBACK(on_view_unmap), state);
 
     g_print("✓ %d bars created for %s layout\n", VISUALIZER_BARS, is_vertical ? "vertical" : "horizontal");
 
-    // Initialize PipeWire
-    state->pw_loop = pw_thread_loop_new("hyprwave-visualizer", NULL);
-    if (!state->pw_loop) {
-        g_printerr("Failed to create PipeWire thread loop\n");
-        return state;
-    }
-
-    state->pw_context = pw_context_new(pw_thread_loop_get_loop(state->pw_loop), NULL, 0);
-    if (!state->pw_context) {
-        g_printerr("Failed to create PipeWire context\n");
-        return state;
-    }
-
-    // Start render loop
-    state->render_timer = g_timeout_add(1000 / VISUALIZER_UPDATE_FPS, update_visualizer, state);
-
     return state;
 }
 
@@ -602,6 +988,7 @@ void visualizer_show(VisualizerState *state) {
 
     // Make visible, then fade in
     gtk_widget_set_visible(state->container, TRUE);
+    start_rendering(state);
     state->fade_opacity = 0.0;
     state->fade_timer = g_timeout_add(16, fade_visualizer, state);
     g_print("Visualizer fading in\n");
@@ -611,6 +998,7 @@ void visualizer_hide(VisualizerState *state) {
     if (!state || !state->is_showing) return;
 
     state->is_showing = FALSE;
+    stop_rendering(state);
 
     if (state->fade_timer > 0) {
         g_source_remove(state->fade_timer);
@@ -620,235 +1008,136 @@ void visualizer_hide(VisualizerState *state) {
     g_print("Visualizer fading out\n");
 }
 
-void visualizer_start(VisualizerState *state) {
-    if (!state || state->is_running || !state->pw_loop) return;
+void visualizer_set_capture_budget(VisualizerState *state, gboolean enabled, gint rate) {
+    if (!state) return;
 
-    pw_thread_loop_lock(state->pw_loop);
+    state->capture_budget = enabled;
+    state->capture_rate = rate > 0 ? (guint)CLAMP(rate, 8000, 192000) : 0;
 
-    // Connect to PipeWire
-    state->pw_core = pw_context_connect(state->pw_context, NULL, 0);
-    if (!state->pw_core) {
-        g_printerr("Failed to connect to PipeWire\n");
-        pw_thread_loop_unlock(state->pw_loop);
-        return;
-    }
+    g_print("✓ Visualizer capture: %s, %s\n",
+            enabled ? "budget (mono, analyzed once per frame)" : "full (stereo, analyzed per quantum)",
+            state->capture_rate > 0 ? "fixed rate" : "native rate");
+}
 
-    // Get registry to find nodes
-    state->pw_registry = pw_core_get_registry(state->pw_core, PW_VERSION_REGISTRY, 0);
-    if (!state->pw_registry) {
-        g_printerr("Failed to get PipeWire registry\n");
-        pw_thread_loop_unlock(state->pw_loop);
-        return;
-    }
+void visualizer_set_capture_source(VisualizerState *state, gboolean stream_only) {
+    if (!state) return;
 
-    spa_zero(state->registry_listener);
-    pw_registry_add_listener(state->pw_registry, &state->registry_listener,
-                             &registry_events, state);
+    state->capture_stream_only = stream_only;
+    g_print("✓ Visualizer source: %s\n",
+            stream_only ? "player stream only" : "player's sink monitor");
+}
 
-    // Create capture stream
-    state->pw_stream = pw_stream_new(state->pw_core, "HyprWave Visualizer",
-        pw_properties_new(
-            PW_KEY_MEDIA_TYPE, "Audio",
-            PW_KEY_MEDIA_CATEGORY, "Capture",
-            PW_KEY_MEDIA_ROLE, "DSP",
-            NULL));
+void visualizer_set_playing(VisualizerState *state, gboolean playing) {
+    if (!state || state->player_playing == playing) return;
 
-    if (!state->pw_stream) {
-        g_printerr("Failed to create PipeWire stream\n");
-        pw_thread_loop_unlock(state->pw_loop);
-        return;
+    state->player_playing = playing;
+
+    // Pausing deactivates the stream; the node stays linked so resuming is instant
+    if (state->is_running) {
+        pw_service_lock();
+        if (state->pw_stream) {
+            pw_stream_set_active(state->pw_stream, playing);
+        }
+        pw_service_unlock();
     }
 
-    spa_zero(state->stream_listener);
-    pw_stream_add_listener(state->pw_stream, &state->stream_listener,
-                           &stream_events, state);
+    g_print("Visualizer: Capture %s\n", playing ? "resumed" : "paused (player paused)");
+}
 
-    // If target serial is known but node not yet matched, search the cache
-    // (node may have been enumerated by registry before target was set)
-    if (state->target_serial > 0 && !state->target_found) {
-        search_cached_nodes_for_target(state);
-    }
-    // If target was already found, connect now
-    if (state->target_found) {
-        connect_to_target(state);
+void visualizer_start(VisualizerState *state) {
+    if (!state || state->is_running) return;
+
+    // One shared connection; the graph was enumerated when it connected
+    if (!pw_service_ensure_connected()) {
+        g_printerr("Failed to connect to PipeWire\n");
+        return;
     }
 
-    pw_thread_loop_unlock(state->pw_loop);
+    pw_service_lock();
 
-    // Start the thread loop
-    if (pw_thread_loop_start(state->pw_loop) < 0) {
-        g_printerr("Failed to start PipeWire thread loop\n");
+    if (!create_capture_stream(state)) {
+        pw_service_unlock();
         return;
     }
 
+    // Subscribing replays every known stream, so a target that is already
+    // playing is found and connected right here
+    state->service_listener = pw_service_add_listener(&service_events, state);
     state->is_running = TRUE;
+
+    pw_service_unlock();
+
     g_print("✓ Visualizer started (AGC-normalized audio capture)\n");
 }
 
 void visualizer_stop(VisualizerState *state) {
     if (!state || !state->is_running) return;
 
-    if (state->pw_loop) {
-        pw_thread_loop_stop(state->pw_loop);
-    }
+    pw_service_lock();
 
-    if (state->pw_stream) {
-        pw_stream_destroy(state->pw_stream);
-        state->pw_stream = NULL;
-    }
+    pw_service_remove_listener(state->service_listener);
+    state->service_listener = 0;
 
-    if (state->pw_registry) {
-        pw_proxy_destroy((struct pw_proxy *)state->pw_registry);
-        state->pw_registry = NULL;
-    }
-
-    if (state->pw_core) {
-        pw_core_disconnect(state->pw_core);
-        state->pw_core = NULL;
-    }
+    destroy_capture_stream(state);
 
     state->is_running = FALSE;
-    g_print("Visualizer stopped\n");
-}
 
-void visualizer_set_target_pid(VisualizerState *state, guint32 pid, const gchar *bus_name) {
-    if (!state) return;
-
-    if (state->target_pid == pid && pid != 0) {
-        return;  // Same target, no change needed
-    }
+    pw_service_unlock();
 
-    g_print("Visualizer: Setting target PID to %u\n", pid);
+    g_print("Visualizer stopped\n");
+}
 
-    state->target_pid = pid;
-    g_free(state->target_bus_name);
-    state->target_bus_name = g_strdup(bus_name);
-    state->target_found = FALSE;
-    state->target_node_id = 0;
-    state->target_serial = -1;
+void visualizer_set_target(VisualizerState *state, const PwPlayerTarget *target) {
+    if (!state || !target) return;
 
-    // Find the sink-input index for this PID using pactl
-    // This handles Chromium/Electron child process lookup
-    gint sink_input = -1;
-    if (pid > 0) {
-        // pw_find_sink_input_by_pid walks the process tree
-        sink_input = pw_find_sink_input_by_pid(pid);
-        if (sink_input < 0) {
-            // Try walking the tree manually
-            gchar *cmd = g_strdup_printf("pgrep -P %u", pid);
-            gchar *output = NULL;
-            if (g_spawn_command_line_sync(cmd, &output, NULL, NULL, NULL) && output) {
-                gchar **child_pids = g_strsplit(output, "\n", -1);
-                for (gchar **p = child_pids; *p && **p; p++) {
-                    guint32 child_pid = (guint32)g_ascii_strtoull(*p, NULL, 10);
-                    if (child_pid > 0) {
-                        sink_input = pw_find_sink_input_by_pid(child_pid);
-                        if (sink_input >= 0) break;
-                    }
-                }
-                g_strfreev(child_pids);
-                g_free(output);
-            }
-            g_free(cmd);
-        }
-    }
+    gboolean same_player = target->pid == state->target_pid &&
+                           g_strcmp0(target->bus_name, state->target_bus_name) == 0;
 
-    // Fallback: match by application name (for ALSA players without process.id)
-    if (sink_input < 0 && bus_name) {
-        // Extract app name from "org.mpris.MediaPlayer2.qobuz-player" -> "qobuz-player"
-        const gchar *prefix = "org.mpris.MediaPlayer2.";
-        const gchar *app_name = bus_name;
-        if (g_str_has_prefix(bus_name, prefix)) {
-            app_name = bus_name + strlen(prefix);
-        }
-        sink_input = pw_find_sink_input_by_app_name(app_name);
+    // Same player: only a newly appeared (or replaced) stream is news.
+    // A failed re-lookup keeps the stream we already have.
+    if (same_player && (target->sink_input < 0 || target->sink_input == state->target_serial)) {
+        return;
     }
 
-    if (sink_input >= 0) {
-        state->target_serial = sink_input;
-        // Look up which sink this stream outputs to
-        state->target_sink_id = pw_find_sink_for_input(sink_input);
+    if (target->sink_input >= 0) {
         g_print("Visualizer: Found sink-input %d for PID %u (sink node %d)\n",
-                sink_input, pid, state->target_sink_id);
+                target->sink_input, target->pid, target->sink);
     } else {
-        state->target_sink_id = -1;
-        g_print("Visualizer: No sink-input found for PID %u\n", pid);
+        g_print("Visualizer: No sink-input found for PID %u\n", target->pid);
     }
 
-    // If running, disconnect current stream and search for new target
-    if (state->is_running && state->pw_loop) {
-        pw_thread_loop_lock(state->pw_loop);
+    // The registry callbacks read the target on the loop thread
+    gboolean locked = state->is_running;
+    if (locked) {
+        pw_service_lock();
         disconnect_stream(state);
-
-        // Search cached nodes for the new target
-        if (state->target_serial > 0) {
-            search_cached_nodes_for_target(state);
-        }
-        pw_thread_loop_unlock(state->pw_loop);
-    }
-}
-
-void visualizer_retry_target(VisualizerState *state) {
-    if (!state || (state->target_pid == 0 && !state->target_bus_name)) return;
-
-    // Already have a valid target, no need to retry
-    if (state->target_serial > 0 && state->target_found) return;
-
-    g_print("Visualizer: Retrying sink-input lookup for PID %u\n", state->target_pid);
-
-    // Re-attempt to find sink-input by PID
-    gint sink_input = -1;
-    if (state->target_pid > 0) {
-        sink_input = pw_find_sink_input_by_pid(state->target_pid);
-        if (sink_input < 0) {
-            // Try child processes
-            gchar *cmd = g_strdup_printf("pgrep -P %u", state->target_pid);
-            gchar *output = NULL;
-            if (g_spawn_command_line_sync(cmd, &output, NULL, NULL, NULL) && output) {
-                gchar **child_pids = g_strsplit(output, "\n", -1);
-                for (gchar **p = child_pids; *p && **p; p++) {
-                    guint32 child_pid = (guint32)g_ascii_strtoull(*p, NULL, 10);
-                    if (child_pid > 0) {
-                        sink_input = pw_find_sink_input_by_pid(child_pid);
-                        if (sink_input >= 0) break;
-                    }
-                }
-                g_strfreev(child_pids);
-                g_free(output);
-            }
-            g_free(cmd);
-        }
     }
 
-    // Fallback: match by application name
-    if (sink_input < 0 && state->target_bus_name) {
-        const gchar *prefix = "org.mpris.MediaPlayer2.";
-        const gchar *app_name = state->target_bus_name;
-        if (g_str_has_prefix(state->target_bus_name, prefix)) {
-            app_name = state->target_bus_name + strlen(prefix);
-        }
-        sink_input = pw_find_sink_input_by_app_name(app_name);
+    if (!same_player) {
+        state->target_pid = target->pid;
+        g_free(state->target_bus_name);
+        state->target_bus_name = g_strdup(target->bus_name);
     }
+    state->target_found = FALSE;
+    state->target_node_id = 0;
+    state->target_serial = target->sink_input;
+    state->target_sink_id = target->sink;
 
-    if (sink_input >= 0 && sink_input != state->target_serial) {
-        state->target_serial = sink_input;
-        state->target_found = FALSE;
-        g_print("Visualizer: Found sink-input %d for PID %u (retry)\n", sink_input, state->target_pid);
-
-        // Search cached nodes
-        if (state->is_running && state->pw_loop) {
-            pw_thread_loop_lock(state->pw_loop);
+    // Search cached nodes for the new target
+    if (locked) {
+        if (state->target_serial > 0) {
             search_cached_nodes_for_target(state);
-            pw_thread_loop_unlock(state->pw_loop);
         }
+        pw_service_unlock();
     }
 }
 
 void visualizer_cleanup(VisualizerState *state) {
     if (!state) return;
 
-    if (state->render_timer > 0) {
-        g_source_remove(state->render_timer);
+    if (state->view) {
+        g_signal_handlers_disconnect_by_data(state->view, state);
+        stop_rendering(state);
     }
 
     if (state->fade_timer > 0) {
@@ -857,21 +1146,19 @@ void visualizer_cleanup(VisualizerState *state) {
 
     visualizer_stop(state);
 
-    if (state->pw_context) {
-        pw_context_destroy(state->pw_context);
-    }
-
-    if (state->pw_loop) {
-        pw_thread_loop_destroy(state->pw_loop);
+    // The shared loop keeps running: let it drain wake-ups the RT thread queued
+    // for us, then drop the idle callbacks they scheduled
+    if (pw_service_get_loop()) {
+        pw_loop_invoke(pw_service_get_loop(), drain_service_loop, 0, NULL, 0, true, NULL);
     }
+    while (g_idle_remove_by_data(state));
 
     g_free(state->target_node_name);
     g_free(state->target_bus_name);
-    if (state->audio_nodes) {
-        g_hash_table_destroy(state->audio_nodes);
-    }
-    g_mutex_clear(&state->data_mutex);
+    g_hash_table_destroy(state->nodes_by_pid);
+    g_hash_table_destroy(state->nodes_by_app);
+    g_hash_table_destroy(state->linked_ports);
+    g_ptr_array_free(state->capture_links, TRUE);
+    spectrum_free(state->spectrum);
     g_free(state);
-
-    pw_deinit();
 }
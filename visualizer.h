@@ -5,21 +5,27 @@
 #include <pipewire/pipewire.h>
 #include <spa/param/audio/format-utils.h>
 #include <spa/utils/hook.h>
+#include "spectrum.h"
+#include "pipewire_volume.h"
 
 #define VISUALIZER_BARS 55
-#define VISUALIZER_UPDATE_FPS 60
+#define VISUALIZER_UPDATE_FPS 60        // Reference rate (and fallback when the monitor rate is unknown)
+#define VISUALIZER_MIN_FPS 30
+#define VISUALIZER_MAX_FPS 240
+#define VISUALIZER_SILENCE_TIMEOUT 3    // Seconds of silence before the render loop sleeps
+#define VISUALIZER_SAMPLE_RATE 48000
+#define VISUALIZER_MONO_CHUNK 1024
+
+// Triple-buffer slot encoding: low bits are the slot index, FRESH marks an unread frame
+#define VISUALIZER_FRAME_INDEX_MASK 0x3
+#define VISUALIZER_FRAME_FRESH 0x4
 
 typedef struct {
-    GtkWidget *container;  // Main container with bars
-    GtkWidget *bars[VISUALIZER_BARS];
+    GtkWidget *container;  // Main container (themed via .visualizer-container)
+    GtkWidget *view;       // Custom-drawn bars (HyprwaveSpectrumView)
 
-    // PipeWire context
-    struct pw_thread_loop *pw_loop;
-    struct pw_context *pw_context;
-    struct pw_core *pw_core;
-    struct pw_registry *pw_registry;
-    struct spa_hook core_listener;
-    struct spa_hook registry_listener;
+    // Subscription to the shared PipeWire service while running
+    guint service_listener;
 
     // PipeWire stream for audio capture
     struct pw_stream *pw_stream;
@@ -34,12 +40,42 @@ typedef struct {
     gchar *target_node_name;      // Node name for logging
     gboolean target_found;        // Whether we found the target node
 
-    // Node cache for searching when target changes
-    GHashTable *audio_nodes;      // node_id -> AudioNodeInfo*
-
-    // Audio data
-    gdouble bar_heights[VISUALIZER_BARS];
+    // Stream indexes over the service model (serial lookups go to the service)
+    GHashTable *nodes_by_pid;     // application.process.id -> const PwServiceNode*
+    GHashTable *nodes_by_app;     // lowercased application.name -> const PwServiceNode*
+
+    // Per-stream capture (links from the player's stream ports to ours)
+    gboolean capture_stream_only; // FALSE = capture the whole sink monitor
+    guint32 target_stream_id;     // PipeWire node ID of the player's stream
+    GHashTable *linked_ports;     // Set of player output port IDs already linked
+    GPtrArray *capture_links;     // struct pw_proxy* links we created
+
+    // Spectrum analysis (RT thread only)
+    Spectrum *spectrum;
+    guint sample_rate;            // Negotiated capture rate in Hz
+    guint channels;               // Negotiated interleaved channels per frame
+
+    // Capture budget (read when connecting)
+    gboolean capture_budget;      // Mono; quanta are copied, analysis runs once per hop
+    guint capture_rate;           // Requested rate in Hz (0 = sink's native rate)
+    float mono_buffer[VISUALIZER_MONO_CHUNK];
+    float band_values[VISUALIZER_BARS];
+    float hop_peak;               // Largest mono |sample| since the last transform
+    double hop_sum_sq;            // Sum of squared mono samples since the last transform
+    gsize hop_samples;            // Mono samples summed into hop_sum_sq
+
+    // Audio data (RT thread only)
     gdouble bar_smoothed[VISUALIZER_BARS];
+    gdouble smoothing;            // Per-hop smoothing factor for smoothing_fps
+    gint smoothing_fps;
+
+    // Lock-free RT -> UI handoff (triple-buffered bar snapshots)
+    float bar_frames[3][VISUALIZER_BARS];
+    gint frame_write;             // Slot owned by the RT thread
+    gint frame_read;              // Slot owned by the UI thread
+    gint frame_shared;            // Atomic: slot index | VISUALIZER_FRAME_FRESH
+    gint reset_pending;           // Atomic: RT must clear its analysis state
+    gint clear_pending;           // Atomic: UI must drop the displayed frame
 
     // Automatic Gain Control (AGC) - makes visualization volume-independent
     gdouble agc_peak;             // Current tracked peak level
@@ -49,32 +85,45 @@ typedef struct {
     // State
     gboolean is_showing;
     gboolean is_running;
+    gboolean player_playing;      // Capture is deactivated while the player is paused
     gboolean is_vertical;         // Layout orientation
-    guint render_timer;
+    guint tick_id;                // Frame-clock tick callback on view (0 while asleep)
+    gint64 last_signal_time;      // Frame time of the last non-silent frame
+    gint render_fps;              // Atomic: display refresh rate the RT hop follows
+    gint render_sleeping;         // Atomic: 1 while no tick is attached
     guint fade_timer;
     gdouble fade_opacity;
-
-    // Thread safety
-    GMutex data_mutex;
 } VisualizerState;
 
 // Initialize visualizer (supports both horizontal and vertical layouts)
-VisualizerState* visualizer_init(gboolean is_vertical);
+// fft_size selects the spectrum resolution (power of two, 256-8192)
+VisualizerState* visualizer_init(gboolean is_vertical, gint fft_size);
 
 // Show/hide visualizer (fades in/out)
 void visualizer_show(VisualizerState *state);
 void visualizer_hide(VisualizerState *state);
 
+// Choose the capture source (call before visualizer_start)
+// stream_only links directly to the player's stream; FALSE captures its whole sink
+void visualizer_set_capture_source(VisualizerState *state, gboolean stream_only);
+
+// Configure the capture budget (call before visualizer_start)
+// enabled requests mono audio in quanta of about one rendered frame; rate > 0 requests
+// a fixed (resampled) capture rate, 0 keeps the sink's native rate
+void visualizer_set_capture_budget(VisualizerState *state, gboolean enabled, gint rate);
+
 // Start/stop audio capture
 void visualizer_start(VisualizerState *state);
 void visualizer_stop(VisualizerState *state);
 
-// Set target player by PID (call when MPRIS player changes)
-// bus_name is used for app-name fallback when PID matching fails (ALSA players)
-void visualizer_set_target_pid(VisualizerState *state, guint32 pid, const gchar *bus_name);
+// Activate/deactivate capture with the player's playback state
+// (a paused player never keeps the sink awake through us)
+void visualizer_set_playing(VisualizerState *state, gboolean playing);
 
-// Retry finding sink-input for current target (call when playback starts)
-void visualizer_retry_target(VisualizerState *state);
+// Point capture at a resolved player (see pw_resolve_player_async()).
+// Call when the MPRIS player changes and again when playback starts,
+// since the audio stream may not exist until then.
+void visualizer_set_target(VisualizerState *state, const PwPlayerTarget *target);
 
 // Cleanup
 void visualizer_cleanup(VisualizerState *state);
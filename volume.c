@@ -14,10 +14,20 @@
  * 1. Try PipeWire sink-input (works for Chromium/Electron apps)
  * 2. Fall back to MPRIS Volume (works for native players like Spotify)
  * 3. If neither works, volume slider is hidden
+ *
+ * The shown value is kept in sync with the system: PipeWire Props events for
+ * the player's stream (or the MPRIS Volume signal) update it as it changes,
+ * so revealing the slider never queries anything.
  */
 
+#define VOLUME_RAMP_PER_SECOND 3.0  // Slew limit: full scale in about 330ms
+#define VOLUME_RAMP_EPSILON 0.001
+
 // Forward declarations
 static void init_pipewire_state(VolumeState *state);
+static void request_sink_input_resolve(VolumeState *state);
+static void on_volume_changed(GtkRange *range, gpointer user_data);
+static gboolean volume_pipeline_busy(VolumeState *state);
 
 static gboolean auto_hide_volume(gpointer user_data) {
     VolumeState *state = (VolumeState *)user_data;
@@ -51,67 +61,289 @@ void volume_update_icon(VolumeState *state, gint percentage) {
     free_path(icon_path);
 }
 
-// Throttled volume setter to prevent lag
-static gboolean delayed_volume_set(gpointer user_data) {
+// Reflect a volume in the slider, icon and label without echoing it back to the player
+// This is now the actual volume, so the command pipeline has nothing left to send.
+static void sync_volume_widgets(VolumeState *state, gdouble volume) {
+    state->current_volume = volume;
+    state->target_volume = volume;
+    state->ramp_volume = volume;
+    state->sent_volume = volume;
+
+    g_signal_handlers_block_by_func(state->slider, on_volume_changed, state);
+    gtk_range_set_value(GTK_RANGE(state->slider), volume);
+    g_signal_handlers_unblock_by_func(state->slider, on_volume_changed, state);
+
+    gint percentage = (gint)round(volume * 100);
+    volume_update_icon(state, percentage);
+
+    gchar *text = g_strdup_printf("%d%%", percentage);
+    gtk_label_set_text(GTK_LABEL(state->percentage), text);
+    g_free(text);
+}
+
+// Volume changed outside the slider (pavucontrol, media keys, the player itself)
+static void apply_external_volume(VolumeState *state, gdouble volume) {
+    // The user is dragging: their value is about to be sent and wins
+    if (volume_pipeline_busy(state)) return;
+
+    sync_volume_widgets(state, CLAMP(volume, 0.0, 1.0));  // Cap at 100% for display
+}
+
+// Main thread: pick up the newest PipeWire volume (events are coalesced)
+static gboolean apply_pipewire_volume(gpointer user_data) {
     VolumeState *state = (VolumeState *)user_data;
 
-    // Try PipeWire first if available
-    if (state->use_pipewire_volume && state->pw_sink_input_index >= 0) {
-        gboolean success = pw_set_volume(state->pw_sink_input_index, state->pending_volume);
-        if (success) {
-            state->pending_set_timer = 0;
-            return G_SOURCE_REMOVE;
-        }
-        // PipeWire failed, sink-input may have changed - try to refresh
+    g_atomic_int_set(&state->event_pending, 0);
+    gint volume = g_atomic_int_get(&state->event_volume);
+    if (state->use_pipewire_volume && volume >= 0) {
+        apply_external_volume(state, volume / 10000.0);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// PipeWire thread: Props event on some stream
+static void on_pipewire_volume_changed(gint sink_input_index, gdouble volume, gpointer user_data) {
+    VolumeState *state = (VolumeState *)user_data;
+
+    if (sink_input_index < 0 || sink_input_index != g_atomic_int_get(&state->pw_sink_input_index)) {
+        return;
+    }
+
+    g_atomic_int_set(&state->event_volume, (gint)lround(volume * 10000.0));
+    if (g_atomic_int_compare_and_exchange(&state->event_pending, 0, 1)) {
+        g_idle_add(apply_pipewire_volume, state);
+    }
+}
+
+// MPRIS players announce Volume through PropertiesChanged
+static void on_mpris_properties_changed(GDBusProxy *proxy, GVariant *changed_properties,
+                                        GStrv invalidated_properties, gpointer user_data) {
+    VolumeState *state = (VolumeState *)user_data;
+    (void)proxy;
+    (void)invalidated_properties;
+
+    if (state->use_pipewire_volume) return;
+
+    gdouble volume;
+    if (g_variant_lookup(changed_properties, "Volume", "d", &volume)) {
+        apply_external_volume(state, volume);
+    }
+}
+
+static void set_mpris_proxy(VolumeState *state, GDBusProxy *mpris_proxy) {
+    if (state->mpris_proxy == mpris_proxy) return;
+
+    if (state->mpris_proxy) {
+        g_signal_handler_disconnect(state->mpris_proxy, state->mpris_volume_handler);
+        g_object_unref(state->mpris_proxy);
+    }
+    state->mpris_volume_handler = 0;
+    state->mpris_proxy = mpris_proxy ? g_object_ref(mpris_proxy) : NULL;
+
+    if (state->mpris_proxy) {
+        state->mpris_volume_handler = g_signal_connect(state->mpris_proxy, "g-properties-changed",
+                                                       G_CALLBACK(on_mpris_properties_changed), state);
+    }
+}
+
+// ========================================
+// VOLUME COMMAND PIPELINE
+// ========================================
+
+typedef struct {
+    gint sink_input;
+    gdouble volume;
+    gchar *bus_name;
+} VolumeCommand;
+
+static void volume_command_free(gpointer data) {
+    VolumeCommand *cmd = (VolumeCommand *)data;
+    g_free(cmd->bus_name);
+    g_free(cmd);
+}
+
+static void send_next_volume(VolumeState *state);
+
+static gboolean volume_pipeline_busy(VolumeState *state) {
+    return state->set_in_flight || state->ramp_tick_id > 0 ||
+           state->ramp_volume != state->target_volume;
+}
+
+// Worker thread: pactl forks and the native backend takes the PipeWire lock
+static void set_volume_thread(GTask *task, gpointer source_object,
+                              gpointer task_data, GCancellable *cancellable) {
+    VolumeCommand *cmd = (VolumeCommand *)task_data;
+    (void)source_object;
+    (void)cancellable;
+
+    gint sink_input = cmd->sink_input;
+    if (!pw_set_volume(sink_input, cmd->volume)) {
+        // Sink-input may have changed - refresh it here rather than on the main loop
         g_print("Volume: PipeWire set failed, refreshing sink-input\n");
-        if (state->mpris_bus_name) {
-            state->pw_sink_input_index = pw_find_sink_input_for_player(state->mpris_bus_name);
-            if (state->pw_sink_input_index >= 0) {
-                pw_set_volume(state->pw_sink_input_index, state->pending_volume);
-            }
+        sink_input = cmd->bus_name ? pw_find_sink_input_for_player(cmd->bus_name) : -1;
+        if (sink_input >= 0 && !pw_set_volume(sink_input, cmd->volume)) {
+            sink_input = -1;
         }
-        state->pending_set_timer = 0;
-        return G_SOURCE_REMOVE;
     }
 
-    // Fall back to MPRIS
-    if (!state->mpris_proxy) {
-        state->pending_set_timer = 0;
+    g_task_return_int(task, sink_input);
+}
+
+static void on_pipewire_volume_set(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GTask *task = G_TASK(result);
+    (void)source;
+
+    // Player changed (or volume control went away): state may be gone, drop the result
+    if (g_cancellable_is_cancelled(g_task_get_cancellable(task))) return;
+
+    VolumeState *state = (VolumeState *)user_data;
+    gint sink_input = (gint)g_task_propagate_int(task, NULL);
+
+    if (sink_input >= 0 && sink_input != g_atomic_int_get(&state->pw_sink_input_index)) {
+        g_print("Volume: Sink-input moved to #%d\n", sink_input);
+        g_atomic_int_set(&state->pw_sink_input_index, sink_input);
+    } else if (sink_input < 0) {
+        g_print("Volume: Failed to set PipeWire volume\n");
+    }
+
+    state->set_in_flight = FALSE;
+    send_next_volume(state);
+}
+
+static void on_mpris_volume_set(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    GVariant *reply = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), result, &error);
+
+    if (reply) {
+        g_variant_unref(reply);
+    } else {
+        gboolean cancelled = g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+        g_error_free(error);
+        if (cancelled) return;  // State may be gone
+    }
+
+    VolumeState *state = (VolumeState *)user_data;
+    state->set_in_flight = FALSE;
+    send_next_volume(state);
+}
+
+// Hand the ramped volume to the backend unless a request is still in flight.
+// Whatever the ramp reached meanwhile is sent when that request completes.
+static void send_next_volume(VolumeState *state) {
+    if (state->set_in_flight || state->ramp_volume == state->sent_volume) return;
+
+    gdouble volume = state->ramp_volume;
+
+    gint sink_input = g_atomic_int_get(&state->pw_sink_input_index);
+    if (state->use_pipewire_volume && sink_input >= 0) {
+        VolumeCommand *cmd = g_new0(VolumeCommand, 1);
+        cmd->sink_input = sink_input;
+        cmd->volume = volume;
+        cmd->bus_name = g_strdup(state->mpris_bus_name);
+
+        GTask *task = g_task_new(NULL, state->set_cancellable, on_pipewire_volume_set, state);
+        g_task_set_task_data(task, cmd, volume_command_free);
+        g_task_run_in_thread(task, set_volume_thread);
+        g_object_unref(task);
+    } else if (state->mpris_proxy) {
+        // Set via MPRIS D-Bus property
+        g_dbus_proxy_call(
+            state->mpris_proxy,
+            "org.freedesktop.DBus.Properties.Set",
+            g_variant_new("(ssv)",
+                "org.mpris.MediaPlayer2.Player",
+                "Volume",
+                g_variant_new_double(volume)),
+            G_DBUS_CALL_FLAGS_NONE,
+            -1,
+            state->set_cancellable,
+            on_mpris_volume_set,
+            state
+        );
+    } else {
+        return;
+    }
+
+    state->sent_volume = volume;
+    state->set_in_flight = TRUE;
+}
+
+// Once per display frame: slew toward the target so the audio never jumps (no zipper noise)
+static gboolean on_volume_ramp_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer user_data) {
+    VolumeState *state = (VolumeState *)user_data;
+    (void)widget;
+
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    gdouble dt = state->ramp_last_time > 0 ? (now - state->ramp_last_time) / (gdouble)G_USEC_PER_SEC
+                                           : 1.0 / 60.0;
+    state->ramp_last_time = now;
+
+    gdouble max_step = VOLUME_RAMP_PER_SECOND * dt;
+    gdouble delta = state->target_volume - state->ramp_volume;
+    if (fabs(delta) <= MAX(max_step, VOLUME_RAMP_EPSILON)) {
+        state->ramp_volume = state->target_volume;
+    } else {
+        state->ramp_volume += delta > 0 ? max_step : -max_step;
+    }
+
+    send_next_volume(state);
+
+    if (state->ramp_volume == state->target_volume) {
+        state->ramp_tick_id = 0;
         return G_SOURCE_REMOVE;
     }
+    return G_SOURCE_CONTINUE;
+}
 
-    // Set via MPRIS D-Bus property
-    g_dbus_proxy_call(
-        state->mpris_proxy,
-        "org.freedesktop.DBus.Properties.Set",
-        g_variant_new("(ssv)",
-            "org.mpris.MediaPlayer2.Player",
-            "Volume",
-            g_variant_new_double(state->pending_volume)),
-        G_DBUS_CALL_FLAGS_NONE,
-        -1,
-        NULL,
-        NULL,
-        NULL
-    );
+// Jump straight to the target (no frames to ramp on) and send it
+static void finish_volume_ramp(VolumeState *state) {
+    if (state->ramp_tick_id > 0) {
+        gtk_widget_remove_tick_callback(state->slider, state->ramp_tick_id);
+        state->ramp_tick_id = 0;
+    }
+    state->ramp_volume = state->target_volume;
+    send_next_volume(state);
+}
 
-    state->pending_set_timer = 0;
-    return G_SOURCE_REMOVE;
+// Request a volume: the newest request replaces any that has not been sent yet
+static void request_volume(VolumeState *state, gdouble volume) {
+    state->target_volume = volume;
+
+    if (!gtk_widget_get_mapped(state->slider)) {
+        finish_volume_ramp(state);
+        return;
+    }
+
+    if (state->ramp_tick_id == 0) {
+        state->ramp_last_time = 0;
+        state->ramp_tick_id = gtk_widget_add_tick_callback(state->slider, on_volume_ramp_tick,
+                                                           state, NULL);
+    }
+}
+
+// Drop in-flight requests for the previous player and ramp state
+static void reset_volume_pipeline(VolumeState *state) {
+    if (state->ramp_tick_id > 0) {
+        gtk_widget_remove_tick_callback(state->slider, state->ramp_tick_id);
+        state->ramp_tick_id = 0;
+    }
+    if (state->set_cancellable) {
+        g_cancellable_cancel(state->set_cancellable);
+        g_object_unref(state->set_cancellable);
+    }
+    state->set_cancellable = g_cancellable_new();
+    state->set_in_flight = FALSE;
+    state->resolve_in_flight = FALSE;
 }
 
 static void on_volume_changed(GtkRange *range, gpointer user_data) {
     VolumeState *state = (VolumeState *)user_data;
     gdouble value = gtk_range_get_value(range);
 
-    state->pending_volume = value;
+    state->current_volume = value;
 
-    // Cancel any pending volume set
-    if (state->pending_set_timer > 0) {
-        g_source_remove(state->pending_set_timer);
-    }
-
-    // Schedule throttled volume set (100ms delay)
-    state->pending_set_timer = g_timeout_add(100, delayed_volume_set, state);
+    // Latest value wins; the frame-clock ramp delivers it without blocking
+    request_volume(state, value);
 
     // Update UI immediately for responsive feel
     gint percentage = (gint)round(value * 100);
@@ -125,14 +357,13 @@ static void on_volume_changed(GtkRange *range, gpointer user_data) {
     reset_hide_timer(state);
 }
 
-/**
- * Initialize PipeWire state based on config and available sink-inputs.
- */
-static void init_pipewire_state(VolumeState *state) {
+// Pick PipeWire or MPRIS for a resolved sink-input (-1 if the player has none)
+static void apply_sink_input(VolumeState *state, gint sink_input) {
     VolumeMethod method = get_config_volume_method();
 
     // Reset PipeWire state
-    state->pw_sink_input_index = -1;
+    g_atomic_int_set(&state->pw_sink_input_index, -1);
+    g_atomic_int_set(&state->event_volume, -1);
     state->use_pipewire_volume = FALSE;
 
     // If MPRIS-only mode, skip PipeWire entirely
@@ -141,47 +372,93 @@ static void init_pipewire_state(VolumeState *state) {
         return;
     }
 
-    // Check if pactl is available
-    if (!pw_is_pactl_available()) {
-        g_print("Volume: pactl not available, using MPRIS\n");
+    if (sink_input >= 0) {
+        g_atomic_int_set(&state->pw_sink_input_index, sink_input);
+        state->use_pipewire_volume = TRUE;
+
+        // Mirror Props changes from now on, so showing the slider never has to ask
+        if (state->pw_watch_id == 0) {
+            state->pw_watch_id = pw_volume_watch(on_pipewire_volume_changed, state);
+        }
+
+        g_print("Volume: Using PipeWire sink-input #%d for %s\n",
+                sink_input, state->mpris_bus_name ? state->mpris_bus_name : "?");
+    } else if (method == VOLUME_METHOD_PIPEWIRE) {
+        // PipeWire-only mode but no sink-input found
+        g_print("Volume: PipeWire mode requested but no sink-input found for %s\n",
+                state->mpris_bus_name ? state->mpris_bus_name : "?");
+    } else {
+        // Auto mode - will fall back to MPRIS
+        g_print("Volume: No PipeWire sink-input found, falling back to MPRIS\n");
+    }
+}
+
+// Sink-input lookup finished on a worker thread
+static void on_sink_input_resolved(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    PwPlayerTarget *target = pw_resolve_player_finish(result, &error);
+    (void)source;
+
+    if (!target) {
+        gboolean cancelled = g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+        g_error_free(error);
+        if (cancelled) return;  // Player changed; state may be gone
+        ((VolumeState *)user_data)->resolve_in_flight = FALSE;
         return;
     }
 
-    // Try to find sink-input for this player
-    if (state->mpris_bus_name) {
-        state->pw_sink_input_index = pw_find_sink_input_for_player(state->mpris_bus_name);
-
-        if (state->pw_sink_input_index >= 0) {
-            state->use_pipewire_volume = TRUE;
-            g_print("Volume: Using PipeWire sink-input #%d for %s\n",
-                    state->pw_sink_input_index, state->mpris_bus_name);
-        } else if (method == VOLUME_METHOD_PIPEWIRE) {
-            // PipeWire-only mode but no sink-input found
-            g_print("Volume: PipeWire mode requested but no sink-input found for %s\n",
-                    state->mpris_bus_name);
-        } else {
-            // Auto mode - will fall back to MPRIS
-            g_print("Volume: No PipeWire sink-input found, falling back to MPRIS\n");
-        }
+    VolumeState *state = (VolumeState *)user_data;
+    state->resolve_in_flight = FALSE;
+    if (g_strcmp0(target->bus_name, state->mpris_bus_name) == 0) {
+        volume_set_sink_input(state, target->sink_input, target->volume);
     }
+    pw_player_target_free(target);
+}
+
+// Look up the player's sink-input and volume without blocking the main loop
+// (D-Bus PID lookup, /proc scan, and pactl when the native backend is down)
+static void request_sink_input_resolve(VolumeState *state) {
+    if (state->resolve_in_flight || !state->mpris_bus_name) return;
+    if (get_config_volume_method() == VOLUME_METHOD_MPRIS) return;
+
+    state->resolve_in_flight = TRUE;
+    pw_resolve_player_async(state->mpris_bus_name, state->set_cancellable,
+                            on_sink_input_resolved, state);
+}
+
+/**
+ * Initialize PipeWire state: MPRIS until the sink-input lookup completes.
+ */
+static void init_pipewire_state(VolumeState *state) {
+    g_atomic_int_set(&state->pw_sink_input_index, -1);
+    g_atomic_int_set(&state->event_volume, -1);
+    state->use_pipewire_volume = FALSE;
+
+    if (get_config_volume_method() == VOLUME_METHOD_MPRIS) {
+        g_print("Volume: Using MPRIS-only mode (config)\n");
+        return;
+    }
+    request_sink_input_resolve(state);
 }
 
 VolumeState* volume_init(GDBusProxy *mpris_proxy, const gchar *mpris_bus_name, gboolean is_vertical) {
     VolumeState *state = g_new0(VolumeState, 1);
-    state->mpris_proxy = mpris_proxy;
     state->mpris_bus_name = g_strdup(mpris_bus_name);
     state->is_showing = FALSE;
     state->hide_timer = 0;
-    state->pending_set_timer = 0;
-    state->pending_volume = 0.5;
-    state->pw_sink_input_index = -1;
+    state->set_cancellable = g_cancellable_new();
+    g_atomic_int_set(&state->pw_sink_input_index, -1);
     state->use_pipewire_volume = FALSE;
+    set_mpris_proxy(state, mpris_proxy);
 
     // Initialize PipeWire state
     init_pipewire_state(state);
 
     // Get current volume (uses PipeWire or MPRIS depending on state)
     state->current_volume = volume_get_current(state);
+    state->target_volume = state->current_volume;
+    state->ramp_volume = state->current_volume;
+    state->sent_volume = state->current_volume;
 
     // Main container
     GtkOrientation orientation = is_vertical ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL;
@@ -252,40 +529,53 @@ VolumeState* volume_init(GDBusProxy *mpris_proxy, const gchar *mpris_bus_name, g
 void volume_update_player(VolumeState *state, GDBusProxy *mpris_proxy, const gchar *mpris_bus_name) {
     if (!state) return;
 
-    // Update MPRIS proxy
-    state->mpris_proxy = mpris_proxy;
+    // Requests still queued or in flight belong to the previous player
+    reset_volume_pipeline(state);
+
+    // Update MPRIS proxy (its Volume signal drives the slider until PipeWire takes over)
+    set_mpris_proxy(state, mpris_proxy);
 
     // Update bus name
     g_free(state->mpris_bus_name);
     state->mpris_bus_name = g_strdup(mpris_bus_name);
 
-    // Reinitialize PipeWire state for new player
-    init_pipewire_state(state);
+    // MPRIS until the player's sink-input is resolved (volume_set_sink_input)
+    g_atomic_int_set(&state->pw_sink_input_index, -1);
+    state->use_pipewire_volume = FALSE;
 
-    g_print("Volume: Updated player to %s (PipeWire: %s, sink-input: %d)\n",
-            mpris_bus_name ? mpris_bus_name : "none",
-            state->use_pipewire_volume ? "yes" : "no",
-            state->pw_sink_input_index);
+    g_print("Volume: Updated player to %s (resolving sink-input)\n",
+            mpris_bus_name ? mpris_bus_name : "none");
+
+    sync_volume_widgets(state, volume_get_current(state));
 }
 
-void volume_show(VolumeState *state) {
-    if (!state || state->is_showing) return;
+void volume_set_sink_input(VolumeState *state, gint sink_input, gdouble volume) {
+    if (!state) return;
 
-    // Update current volume (from PipeWire or MPRIS)
-    state->current_volume = volume_get_current(state);
+    // A failed re-lookup keeps the stream we already have
+    if (sink_input < 0 && state->use_pipewire_volume) return;
 
-    // Block signal to prevent triggering on_volume_changed
-    g_signal_handlers_block_by_func(state->slider, on_volume_changed, state);
-    gtk_range_set_value(GTK_RANGE(state->slider), state->current_volume);
-    g_signal_handlers_unblock_by_func(state->slider, on_volume_changed, state);
+    // Same stream: only refresh the mirrored volume
+    if (sink_input == g_atomic_int_get(&state->pw_sink_input_index) && state->use_pipewire_volume) {
+        if (volume >= 0.0) {
+            g_atomic_int_set(&state->event_volume, (gint)lround(volume * 10000.0));
+            apply_external_volume(state, volume);
+        }
+        return;
+    }
 
-    gint percentage = (gint)round(state->current_volume * 100);
-    volume_update_icon(state, percentage);
+    reset_volume_pipeline(state);
+    apply_sink_input(state, sink_input);
+    if (state->use_pipewire_volume && volume >= 0.0) {
+        g_atomic_int_set(&state->event_volume, (gint)lround(volume * 10000.0));
+    }
+    sync_volume_widgets(state, volume_get_current(state));
+}
 
-    gchar *text = g_strdup_printf("%d%%", percentage);
-    gtk_label_set_text(GTK_LABEL(state->percentage), text);
-    g_free(text);
+void volume_show(VolumeState *state) {
+    if (!state || state->is_showing) return;
 
+    // The slider already mirrors the live volume (PipeWire/MPRIS events), so just reveal it
     // Show with animation
     state->is_showing = TRUE;
     gtk_revealer_set_reveal_child(GTK_REVEALER(state->revealer), TRUE);
@@ -305,11 +595,8 @@ void volume_hide(VolumeState *state) {
         state->hide_timer = 0;
     }
 
-    // Cancel any pending volume set
-    if (state->pending_set_timer > 0) {
-        g_source_remove(state->pending_set_timer);
-        state->pending_set_timer = 0;
-    }
+    // No more frames while hidden: deliver the final value instead of dropping it
+    finish_volume_ramp(state);
 
     // Hide with animation
     gtk_revealer_set_reveal_child(GTK_REVEALER(state->revealer), FALSE);
@@ -321,51 +608,18 @@ void volume_set(VolumeState *state, gdouble volume) {
     if (volume > 1.0) volume = 1.0;
 
     state->current_volume = volume;
-    state->pending_volume = volume;
-
-    // Try PipeWire first
-    if (state->use_pipewire_volume && state->pw_sink_input_index >= 0) {
-        if (pw_set_volume(state->pw_sink_input_index, volume)) {
-            return;
-        }
-    }
-
-    // Fall back to MPRIS
-    if (!state->mpris_proxy) return;
-
-    g_dbus_proxy_call(
-        state->mpris_proxy,
-        "org.freedesktop.DBus.Properties.Set",
-        g_variant_new("(ssv)",
-            "org.mpris.MediaPlayer2.Player",
-            "Volume",
-            g_variant_new_double(volume)),
-        G_DBUS_CALL_FLAGS_NONE,
-        -1,
-        NULL,
-        NULL,
-        NULL
-    );
+    request_volume(state, volume);
 }
 
 gdouble volume_get_current(VolumeState *state) {
-    // Try PipeWire first
-    if (state->use_pipewire_volume && state->pw_sink_input_index >= 0) {
-        gdouble vol = pw_get_volume(state->pw_sink_input_index);
-        if (vol >= 0.0) {
-            return vol > 1.0 ? 1.0 : vol;  // Cap at 100% for display
-        }
-        // PipeWire failed, sink-input may have changed
-        g_print("Volume: PipeWire get failed, refreshing sink-input\n");
-        if (state->mpris_bus_name) {
-            state->pw_sink_input_index = pw_find_sink_input_for_player(state->mpris_bus_name);
-            if (state->pw_sink_input_index >= 0) {
-                vol = pw_get_volume(state->pw_sink_input_index);
-                if (vol >= 0.0) {
-                    return vol > 1.0 ? 1.0 : vol;
-                }
-            }
+    // PipeWire: the volume mirrored from the lookup and Props events
+    if (state->use_pipewire_volume && g_atomic_int_get(&state->pw_sink_input_index) >= 0) {
+        gint cached = g_atomic_int_get(&state->event_volume);
+        if (cached >= 0) {
+            return MIN(cached / 10000.0, 1.0);  // Cap at 100% for display
         }
+        // Not known yet: look it up off the main thread, MPRIS meanwhile
+        request_sink_input_resolve(state);
     }
 
     // Fall back to MPRIS
@@ -387,7 +641,7 @@ gboolean volume_is_supported(VolumeState *state) {
     if (!state) return FALSE;
 
     // PipeWire volume is always "supported" if we have a valid sink-input
-    if (state->use_pipewire_volume && state->pw_sink_input_index >= 0) {
+    if (state->use_pipewire_volume && g_atomic_int_get(&state->pw_sink_input_index) >= 0) {
         return TRUE;
     }
 
@@ -432,10 +686,18 @@ void volume_cleanup(VolumeState *state) {
         g_source_remove(state->hide_timer);
     }
 
-    if (state->pending_set_timer > 0) {
-        g_source_remove(state->pending_set_timer);
+    if (state->ramp_tick_id > 0) {
+        gtk_widget_remove_tick_callback(state->slider, state->ramp_tick_id);
     }
 
+    // In-flight completions see the cancellation and never touch state
+    g_cancellable_cancel(state->set_cancellable);
+    g_object_unref(state->set_cancellable);
+
+    pw_volume_unwatch(state->pw_watch_id);
+    while (g_idle_remove_by_data(state));
+    set_mpris_proxy(state, NULL);
+
     g_free(state->mpris_bus_name);
     g_free(state);
 }
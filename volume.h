@@ -12,34 +12,55 @@ typedef struct {
     GtkWidget *slider;
     GtkWidget *percentage;
     gdouble current_volume;
-    gdouble pending_volume;  // For throttled updates
     gboolean is_showing;
     guint hide_timer;
-    guint pending_set_timer;  // For throttled volume setting
+
+    // Volume command pipeline: latest value wins, one request in flight,
+    // and the applied volume ramps toward the target once per display frame
+    gdouble target_volume;       // Latest requested volume
+    gdouble ramp_volume;         // Ramped volume, moves toward target_volume
+    gdouble sent_volume;         // Last volume handed to the backend
+    guint ramp_tick_id;          // Frame-clock tick on the slider while ramping
+    gint64 ramp_last_time;
+    gboolean set_in_flight;      // A backend request has not completed yet
+    gboolean resolve_in_flight;  // A sink-input lookup has not completed yet
+    GCancellable *set_cancellable; // Cancelled when the player changes
 
     // PipeWire per-application volume control
     gchar *mpris_bus_name;       // D-Bus name for PID extraction
-    gint pw_sink_input_index;    // PipeWire sink-input index, -1 if not found
+    gint pw_sink_input_index;    // PipeWire sink-input index, -1 if not found (atomic: read by the PipeWire thread)
     gboolean use_pipewire_volume; // TRUE if using PipeWire, FALSE for MPRIS
+
+    // Live mirror of the player's volume (PipeWire Props events / MPRIS Volume signal)
+    guint pw_watch_id;           // PipeWire volume watch, 0 if events are unavailable
+    gint event_volume;           // Atomic: latest PipeWire volume in 1/10000 steps, -1 if unknown
+    gint event_pending;          // Atomic: an update is queued on the main loop
+    gulong mpris_volume_handler; // g-properties-changed on mpris_proxy (we hold a ref)
 } VolumeState;
 
 // Initialize volume control
 // mpris_bus_name is used to find the PipeWire sink-input for PID-based mapping
 VolumeState* volume_init(GDBusProxy *mpris_proxy, const gchar *mpris_bus_name, gboolean is_vertical);
 
-// Update the MPRIS proxy and reinitialize PipeWire state (call when player changes)
+// Update the MPRIS proxy (call when player changes)
+// Volume goes through MPRIS until volume_set_sink_input() supplies the player's stream
 void volume_update_player(VolumeState *state, GDBusProxy *mpris_proxy, const gchar *mpris_bus_name);
 
-// Show volume control with animation
+// Use a sink-input resolved off the main thread (see pw_resolve_player_async())
+// -1 means the player has no stream yet; an already-known stream is kept.
+// volume is the stream's volume from the same lookup, -1.0 if unknown.
+void volume_set_sink_input(VolumeState *state, gint sink_input, gdouble volume);
+
+// Show volume control with animation (uses the mirrored volume, no query)
 void volume_show(VolumeState *state);
 
 // Hide volume control with animation
 void volume_hide(VolumeState *state);
 
-// Set volume via MPRIS (0.0 to 1.0)
+// Set volume (0.0 to 1.0) through the command pipeline (never blocks)
 void volume_set(VolumeState *state, gdouble volume);
 
-// Get current volume from MPRIS
+// Get current volume: the mirrored PipeWire volume, else MPRIS (never blocks)
 gdouble volume_get_current(VolumeState *state);
 
 // Check if current player supports volume control